@@ -13,13 +13,25 @@
 ///
 
 
+#include <assert.h>
 #include <getopt.h>
+#include <signal.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "binairo_board.h"
 #include "binairo_bt.h"
+#include "binairo_corpus.h"
+#include "binairo_count.h"
+#include "binairo_lanes.h"
+#include "binairo_large.h"
+#include "binairo_memo.h"
+#include "binairo_perf.h"
+#include "binairo_portfolio.h"
+#include "binairo_session.h"
 #include "display.h"
 
 
@@ -30,7 +42,179 @@
 /// executing program occurs
 ///
 static void print_usage(){
-    fprintf( stderr, "usage: binairo [-f filename] [-d enable graphic debugging] [-t delay]\n" ); 
+    fprintf( stderr, "usage: binairo [-f filename] [-d enable graphic debugging] [-t delay]"
+                        " [-l time limit in seconds] [-n node limit]"
+                        " [-s random seed] [-r restart unit] [-p solver threads]"
+                        " [-L probing depth] [-H print a hint] [-c count solutions]\n"
+                     "       binairo -b [options] puzzle files...\n"
+                     "       binairo -w workers [-S shard size] [-k checkpoint directory]"
+                     " [options] -f corpus\n"
+                     "       --perf[=csv file] count hardware events in each phase\n"
+                     "       [-B bt|cdcl search backend] [-e seq|net CDCL line encoding]"
+                     " [-D file write the DIMACS encoding] [-M print line memo counters]\n" ); 
+}
+
+
+/// set by SIGINT to stop the search early; a lock-free atomic, so it
+/// is safe both from the handler and across the portfolio's threads
+static atomic_int cancelled = 0;
+
+///
+/// on_interrupt
+///
+/// SIGINT handler that cancels the running search, which then
+/// reports the partial board it reached
+///
+/// @param sig - the signal number
+///
+static void on_interrupt( int sig ){
+    (void)sig;
+    atomic_store_explicit( &cancelled, 1, memory_order_relaxed );
+}
+
+
+///
+/// print_board
+///
+/// prints a board to standard output, pretty printed, or streamed as
+/// a configuration once it is large enough for the large-board solver
+///
+/// @param brd - the board
+///
+static void print_board( BinairoBoard brd ){
+    if( dim_BinairoBoard( brd ) >= LARGE_MIN_DIM )
+        stream_BinairoBoard( brd, stdout );
+    else
+        print_BinairoBoard( brd, stdout );
+}
+
+
+///
+/// print_gave_up
+///
+/// prints the partial board left by a search that hit a limit,
+/// along with how many of its cells were proven by propagation
+///
+/// @param brd - the partially solved board
+///
+static void print_gave_up( BinairoBoard brd ){
+    int dim = dim_BinairoBoard( brd );
+    int cell, proven = 0;
+
+    for( cell=0; cell<dim*dim; cell++ )
+        if( is_proven_BinairoBoard( brd, cell ) )
+            proven++;
+
+    printf( "\nGave Up! Partial board (%d cells proven by propagation):\n", proven );
+    print_board( brd );
+    puts( "" );
+}
+
+
+///
+/// solve_batch
+///
+/// solves every puzzle file given, routing the boards that share a
+/// small even dimension through the lanes, and prints each outcome in
+/// the order the files were given
+///
+/// @param files - the names of the puzzle files
+/// @param count - the number of files
+/// @param options - the limits for each backtracker
+///
+/// @return - false if a file could not be read; otherwise, true
+///
+static bool solve_batch( char* files[], int count, const SolveOptions* options ){
+    BinairoBoard* boards = calloc( count, sizeof( BinairoBoard ) );
+    BinairoBoard* group = calloc( count, sizeof( BinairoBoard ) );
+    SolveResult* results = calloc( count, sizeof( SolveResult ) );
+    SolveResult* group_results = calloc( count, sizeof( SolveResult ) );
+    bool* done = calloc( count, sizeof( bool ) );
+    int i, j, size, dim, settled = 0, solved = 0;
+    bool ok = true;
+
+    assert( boards && group && results && group_results && done );
+
+    for( i=0; i<count && ok; i++ ){
+        FILE* file = fopen( files[i], "r" );
+        if( file == NULL ){
+            fprintf( stderr, "Error: %s: No such file or directory\n", files[i] );
+            ok = false;
+            break;
+        }
+        enter_perf( PHASE_PARSE );
+        boards[i] = create_BinairoBoard( file );
+        leave_perf( PHASE_PARSE );
+        fclose( file );
+        if( boards[i] == NULL ){
+            fprintf( stderr, "Error: Unable to create Binairo Board from %s\n", files[i] );
+            ok = false;
+        }
+    }
+
+    // every board of a dimension that fits the lanes goes through them together
+    for( i=0; i<count && ok; i++ ){
+        if( done[i] )
+            continue;
+        dim = dim_BinairoBoard( boards[i] );
+        if( dim % 2 != 0 || dim > LANES_MAX_DIM ){
+            bt_initialize( boards[i], false, 0 );
+            results[i] = solve_bounded( options );
+            done[i] = true;
+            continue;
+        }
+        for( size=0, j=i; j<count; j++ )
+            if( !done[j] && dim_BinairoBoard( boards[j] ) == dim )
+                group[size++] = boards[j];
+        settled += solve_lanes( group, size, options, group_results );
+        for( size=0, j=i; j<count; j++ )
+            if( !done[j] && dim_BinairoBoard( boards[j] ) == dim ){
+                results[j] = group_results[size++];
+                done[j] = true;
+            }
+    }
+
+    enter_perf( PHASE_OUTPUT );
+    for( i=0; i<count && ok; i++ ){
+        printf( "\n%s: %s\n", files[i], results[i] == SOLVED ? "Solution:" :
+                results[i] == NO_SOLUTION ? "No Solution!" : "Gave Up!" );
+        if( results[i] != NO_SOLUTION )
+            print_board( boards[i] );
+        solved += results[i] == SOLVED;
+    }
+    if( ok )
+        printf( "\nSolved %d of %d puzzles, %d settled without search.\n\n",
+                solved, count, settled );
+    leave_perf( PHASE_OUTPUT );
+
+    for( i=0; i<count; i++ )
+        if( boards[i] != NULL )
+            destroy_BinairoBoard( boards[i] );
+    free( boards );
+    free( group );
+    free( results );
+    free( group_results );
+    free( done );
+    return ok;
+}
+
+
+///
+/// report_perf
+///
+/// prints the events counted in each phase, and appends them to a
+/// CSV file if one was given
+///
+/// @param csv - the CSV file, or NULL
+/// @param label - what was measured, for the CSV file
+///
+static void report_perf( const char* csv, const char* label ){
+    puts( "Performance counters:" );
+    print_perf( stdout );
+    puts( "" );
+    if( csv != NULL && !write_perf_csv( csv, label ) )
+        fprintf( stderr, "Error: unable to write %s\n", csv );
+    close_perf( );
 }
 
 
@@ -46,9 +230,25 @@ int main( int argc, char* argv[] ){
     FILE* config_file = stdin;
     bool debug = false;
 	double dummy = 0, delay = 1000000;
+    CheckReport report = { .rule = CONSISTENT };
+    SolveOptions options = { .cancel = &cancelled, .report = &report };
+    int threads = 1;
+    bool hint = false, count = false, batch = false;
+    const char* config_name = NULL;
+    const char* checkpoints = NULL;
+    int workers = 0, shard_size = CORPUS_SHARD_SIZE;
+    bool perf = false;
+    const char* perf_csv = NULL;
+    const char* dimacs = NULL;
+    bool memo_stats = false;
+    static const struct option long_options[] = {
+        { "perf", optional_argument, NULL, 'P' },
+        { NULL, 0, NULL, 0 }
+    };
     char flag;
 
-    while( ( flag = getopt( argc, argv, "df:t:" ) ) != -1 ){
+    while( ( flag = getopt_long( argc, argv, "df:t:l:n:s:r:p:L:Hcbw:S:k:B:e:D:M", long_options,
+                                 NULL ) ) != -1 ){
         switch( flag ) {
             case 'f':
                 config_file = fopen( optarg, "r" );
@@ -56,6 +256,7 @@ int main( int argc, char* argv[] ){
                     fprintf( stderr, "Argument for (-f): No such file or directory\n" );
                     return EXIT_FAILURE;
                 }
+                config_name = optarg;
                 break;
             case 'd':
                 debug = true;
@@ -64,6 +265,75 @@ int main( int argc, char* argv[] ){
 				dummy = strtod( optarg, NULL );
 				delay = dummy > 0 ? dummy : delay;
 				break;
+            case 'l':
+                options.deadline = strtod( optarg, NULL );
+                break;
+            case 'n':
+                options.max_nodes = strtoul( optarg, NULL, 10 );
+                break;
+            case 's':
+                options.seed = strtoul( optarg, NULL, 10 );
+                break;
+            case 'r':
+                options.restart_unit = strtoul( optarg, NULL, 10 );
+                break;
+            case 'p':
+                threads = atoi( optarg );
+                threads = threads > 0 ? threads : 1;
+                break;
+            case 'L':
+                options.probe_depth = atoi( optarg );
+                break;
+            case 'H':
+                hint = true;
+                break;
+            case 'c':
+                count = true;
+                break;
+            case 'b':
+                batch = true;
+                break;
+            case 'w':
+                workers = atoi( optarg );
+                workers = workers > 0 ? workers : 1;
+                break;
+            case 'S':
+                shard_size = atoi( optarg );
+                shard_size = shard_size > 0 ? shard_size : CORPUS_SHARD_SIZE;
+                break;
+            case 'k':
+                checkpoints = optarg;
+                break;
+            case 'B':
+                if( strcmp( optarg, "cdcl" ) == 0 )
+                    options.backend = CDCL;
+                else if( strcmp( optarg, "bt" ) == 0 )
+                    options.backend = BACKTRACK;
+                else{
+                    print_usage();
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'e':
+                if( strcmp( optarg, "net" ) == 0 )
+                    options.encoding = CARDINALITY_NETWORK;
+                else if( strcmp( optarg, "seq" ) == 0 )
+                    options.encoding = SEQUENTIAL_COUNTER;
+                else{
+                    print_usage();
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'D':
+                dimacs = optarg;
+                break;
+            case 'M':
+                memo_stats = true;
+                break;
+            case 'P':
+                perf = true;
+                perf_csv = optarg;
+                break;
             case '?':
                 print_usage();
                 return EXIT_FAILURE;
@@ -71,10 +341,39 @@ int main( int argc, char* argv[] ){
 
     }
 
+    // count events on this thread from here on
+    if( perf )
+        open_perf( stderr );
+
+    // every puzzle named after the options, in lanes
+    if( batch ){
+        if( optind >= argc ){
+            print_usage();
+            return EXIT_FAILURE;
+        }
+        options.report = NULL;
+        signal( SIGINT, on_interrupt );
+        bool solved = solve_batch( argv + optind, argc - optind, &options );
+        if( perf )
+            report_perf( perf_csv, "batch" );
+        return solved ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // a corpus of one-line puzzles, sharded over worker processes
+    if( workers > 0 ){
+        if( config_name == NULL ){
+            print_usage();
+            return EXIT_FAILURE;
+        }
+        fclose( config_file );
+        return run_corpus( config_name, workers, shard_size, checkpoints, &options ) ?
+               EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     // initial board 
+    enter_perf( PHASE_PARSE );
     BinairoBoard brd = create_BinairoBoard( config_file );
-
-    bt_initialize( brd, debug, delay );
+    leave_perf( PHASE_PARSE );
 
     if( brd == NULL ){
         fprintf( stderr, "Error: Unable to create Binairo Board\n");
@@ -82,37 +381,106 @@ int main( int argc, char* argv[] ){
         return EXIT_FAILURE;
     }
 
+    // the formula only, for an offline SAT solver
+    if( dimacs != NULL ){
+        FILE* out = fopen( dimacs, "w" );
+        if( out == NULL ){
+            fprintf( stderr, "Argument for (-D): unable to write %s\n", dimacs );
+            destroy_BinairoBoard( brd );
+            fclose( config_file );
+            return EXIT_FAILURE;
+        }
+        Cnf cnf = create_Cnf( brd, options.encoding );
+        write_Cnf( cnf, out );
+        fclose( out );
+        destroy_Cnf( cnf );
+        destroy_BinairoBoard( brd );
+        fclose( config_file );
+        return EXIT_SUCCESS;
+    }
+
+    bt_initialize( brd, debug, delay );
+
+
+    signal( SIGINT, on_interrupt );
 
     // toggle debug flag
     if( debug ){
         clear();
-        if( !solve( ) ){
-            set_cur_pos( 2*dim_BinairoBoard( brd )+2, 1 );
-            puts( "No Solution!" );
-        }
-        else{
-            set_cur_pos( 2*dim_BinairoBoard( brd )+2, 1 );
-            puts( "Solution!" );
-        }   
+        SolveResult res = solve_bounded( &options );
+        set_cur_pos( 2*dim_BinairoBoard( brd )+2, 1 );
+        puts( res == SOLVED ? "Solution!" : res == GAVE_UP ? "Gave Up!" : "No Solution!" );
     }   
+    else if( count ){
+        puts("\nInitial Board:");
+        print_BinairoBoard( brd, stdout );
+
+        // every solution, without printing them
+        unsigned long long solutions;
+        CountStats stats;
+        if( count_BinairoBoard( brd, threads, &solutions, &stats ) )
+            printf( "\nSolutions: %llu (%zu half boards kept in %.1f MiB)\n\n", solutions,
+                    stats.states, stats.bytes / ( 1024.0 * 1024.0 ) );
+        else if( dim_BinairoBoard( brd ) > COUNT_MAX_DIM || dim_BinairoBoard( brd ) % 2 != 0 )
+            printf( "\nError: counting handles even dimensions up to %d.\n\n", COUNT_MAX_DIM );
+        else
+            puts( "\nError: board too open to count; give it more givens.\n" );
+    }
+    else if( hint ){
+        puts("\nInitial Board:");
+        print_BinairoBoard( brd, stdout );
+
+        // the next logical deduction, without solving
+        BinairoSession session = create_BinairoSession( brd );
+        Hint next;
+        puts( "" );
+        if( hint_BinairoSession( session, &next ) )
+            print_Hint( &next, dim_BinairoBoard( brd ), stdout );
+        else
+            puts( "No cell can be deduced." );
+        puts( "" );
+        destroy_BinairoSession( session );
+    }
     else{
 
         // print the initial board
         puts("\nInitial Board:");
-        print_BinairoBoard( brd, stdout );
+        print_board( brd );
 
         // finding a solution
         bt_initialize( brd, debug, delay );
-        if( !solve( ) ){
-            printf( "\nNo Solution!\n\n" );
-        }
-        else{
-            printf( "\nSolution:\n" );
-            print_BinairoBoard( brd, stdout );  
-            puts("");
+        SolveResult res = threads > 1 ? solve_portfolio( brd, threads, &options ) :
+                                        solve_bounded( &options );
+        switch( res ){
+            case SOLVED:
+                enter_perf( PHASE_OUTPUT );
+                printf( "\nSolution:\n" );
+                print_board( brd );  
+                puts("");
+                leave_perf( PHASE_OUTPUT );
+                break;
+            case NO_SOLUTION:
+                printf( "\nNo Solution!\n" );
+                if( report.rule != CONSISTENT )
+                    print_CheckReport( &report, dim_BinairoBoard( brd ), stdout );
+                puts( "" );
+                break;
+            case GAVE_UP:
+                print_gave_up( brd );
+                break;
         }
     }   
 
+    if( perf )
+        report_perf( perf_csv, config_name != NULL ? config_name : "stdin" );
+
+    // the line memo, over the main thread and every joined worker
+    if( memo_stats ){
+        LineMemoStats stats;
+        stats_LineMemo( &stats );
+        print_LineMemoStats( &stats, stderr );
+    }
+
     destroy_BinairoBoard( brd );
     fclose( config_file );    
 
@@ -40,6 +40,7 @@ struct BinairoBoardStruct {
     RowInfo** r_contents;		/// filled content on board in rows, either '0' or '1'
 	ColInfo** c_contents;		/// filed content on board in columns
     bool* marked;           	/// is the board already marked from the given config file
+    bool* proven;               /// was the cell's digit proven by propagation
     int dim;                	/// dimension of the board
 };
 
@@ -78,8 +79,9 @@ BinairoBoard create_BinairoBoard( FILE* config_file ){
 	brd->c_contents = calloc( size, sizeof( ColInfo* ) );
     brd->r_contents = calloc( size, sizeof( RowInfo* ) );
     brd->marked = calloc( size * size, sizeof( bool ) );
+    brd->proven = calloc( size * size, sizeof( bool ) );
 
-    assert( brd->r_contents && brd->c_contents && brd->marked );
+    assert( brd->r_contents && brd->c_contents && brd->marked && brd->proven );
 
 	// make each column info
 	for( size_t i=0; i<size; i++ ){
@@ -161,39 +163,104 @@ BinairoBoard create_BinairoBoard( FILE* config_file ){
 }
 
 
+/// deep copy of a board
+BinairoBoard copy_BinairoBoard( BinairoBoard b ){
+    assert( b );
+    size_t size = b->dim;
+
+    BinairoBoard brd = malloc( sizeof( struct BinairoBoardStruct ) );
+    assert( brd );
+
+    brd->dim = b->dim;
+    brd->c_contents = calloc( size, sizeof( ColInfo* ) );
+    brd->r_contents = calloc( size, sizeof( RowInfo* ) );
+    brd->marked = malloc( size * size * sizeof( bool ) );
+    brd->proven = malloc( size * size * sizeof( bool ) );
+
+    assert( brd->r_contents && brd->c_contents && brd->marked && brd->proven );
+
+    memcpy( brd->marked, b->marked, size * size * sizeof( bool ) );
+    memcpy( brd->proven, b->proven, size * size * sizeof( bool ) );
+
+    for( size_t i=0; i<size; i++ ){
+        brd->r_contents[i] = malloc( sizeof( RowInfo ) );
+        brd->c_contents[i] = malloc( sizeof( ColInfo ) );
+        assert( brd->r_contents[i] && brd->c_contents[i] );
+
+        brd->r_contents[i]->row = malloc( size );
+        brd->c_contents[i]->col = malloc( size );
+        assert( brd->r_contents[i]->row && brd->c_contents[i]->col );
+
+        memcpy( brd->r_contents[i]->row, b->r_contents[i]->row, size );
+        brd->r_contents[i]->num_of_0s = b->r_contents[i]->num_of_0s;
+        brd->r_contents[i]->num_of_1s = b->r_contents[i]->num_of_1s;
+
+        memcpy( brd->c_contents[i]->col, b->c_contents[i]->col, size );
+        brd->c_contents[i]->num_of_0s = b->c_contents[i]->num_of_0s;
+        brd->c_contents[i]->num_of_1s = b->c_contents[i]->num_of_1s;
+    }
+
+    return brd;
+}
+
+
 ///
 /// print_border
 ///
-/// helper function to print the border of the binairo board
+/// helper function to build the border of the binairo board
 ///
 /// @param dim      the dimension of the board
-/// @param stream   the place to print the border
+/// @param buffer   where the border is built, 2*dim+3 chars
 ///
-static void print_border( size_t dim, FILE* stream ){
-    fputc( '+', stream );
-    for( size_t j=0; j<dim; j++ )
-        fputs( "-+", stream );
-
-    fputc( '\n', stream );  
+static void print_border( size_t dim, char* buffer ){
+    buffer[0] = '+';
+    for( size_t j=0; j<dim; j++ ){
+        buffer[2*j+1] = '-';
+        buffer[2*j+2] = '+';
+    }
+    buffer[2*dim+1] = '\n';
+    buffer[2*dim+2] = '\0';
 }
 
 
-/// pretty print the board
+/// pretty print the board, a line at a time
 void print_BinairoBoard( BinairoBoard brd, FILE* stream ){
+    char* border = malloc( 2*brd->dim + 3 );
+    char* line = malloc( 2*brd->dim + 3 );
     int i,j;
 
+    assert( border && line );
+    print_border( brd->dim, border );
+
     // print top border
-    print_border( brd->dim, stream );
+    fputs( border, stream );
 
     // print contents
     for( i=0; i<brd->dim; i++ ){
-        fputc( '|', stream );
-        for( j=0; j<brd->dim; j++ ) 
-            fprintf( stream, "%c|", brd->r_contents[i]->row[j] );
-        fputc( '\n', stream );
-        
+        line[0] = '|';
+        for( j=0; j<brd->dim; j++ ){
+            line[2*j+1] = brd->r_contents[i]->row[j];
+            line[2*j+2] = '|';
+        }
+        line[2*brd->dim+1] = '\n';
+        line[2*brd->dim+2] = '\0';
+        fputs( line, stream );
+
         // print inner (and bottom) border
-        print_border( brd->dim, stream );   
+        fputs( border, stream );
+    }
+
+    free( border );
+    free( line );
+}
+
+
+/// stream the board as a configuration
+void stream_BinairoBoard( BinairoBoard brd, FILE* stream ){
+    fprintf( stream, "%d\n", brd->dim );
+    for( int i=0; i<brd->dim; i++ ){
+        fwrite( brd->r_contents[i]->row, 1, brd->dim, stream );
+        fputc( '\n', stream );
     }
 }
 
@@ -202,12 +269,16 @@ void print_BinairoBoard( BinairoBoard brd, FILE* stream ){
 ///
 /// free:
 ///     brd->marked
+///     brd->proven
 ///     brd->contents
 ///         contents->row
 void destroy_BinairoBoard( BinairoBoard brd ){
     if( brd->marked != NULL )
         free( brd->marked );
 
+    if( brd->proven != NULL )
+        free( brd->proven );
+
     if( brd->r_contents != NULL ){
         for( int i=0; i<brd->dim; i++ ){
             if( brd->r_contents[i] != NULL ){
@@ -248,6 +319,20 @@ bool is_marked_BinairoBoard( BinairoBoard b, int cell ){
 }
 
 
+/// flag a cell as proven
+void prove_BinairoBoard( BinairoBoard b, int cell ){
+    assert( b );
+    b->proven[cell] = true;
+}
+
+
+/// was the cell proven by propagation?
+bool is_proven_BinairoBoard( BinairoBoard b, int cell ){
+    assert( b );
+    return b->proven[cell];
+}
+
+
 #define COL( b, cell ) 		b->c_contents[cell%b->dim]
 #define ROW( b, cell )        b->r_contents[cell/b->dim]  
 #define SPOT( b, cell )     b->r_contents[cell/b->dim]->row[cell%b->dim]
@@ -293,6 +378,26 @@ void put_BinairoBoard( BinairoBoard b, int cell, Digit digit ){
 }
 
 
+/// make a cell a given, or no longer one
+void give_BinairoBoard( BinairoBoard b, int cell, Digit digit ){
+    assert( b );
+    put_BinairoBoard( b, cell, digit );
+    b->marked[cell] = digit != BLANK;
+    b->proven[cell] = false;
+}
+
+
+/// blank every cell that is not given
+void clear_BinairoBoard( BinairoBoard b ){
+    assert( b );
+    for( int cell=0; cell<b->dim*b->dim; cell++ ){
+        if( !b->marked[cell] )
+            put_BinairoBoard( b, cell, BLANK );
+        b->proven[cell] = false;
+    }
+}
+
+
 /// get digit from a cell on board
 Digit get_BinairoBoard( BinairoBoard b, int cell ){
     assert( b );
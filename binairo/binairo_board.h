@@ -48,6 +48,19 @@ typedef struct BinairoBoardStruct* BinairoBoard;
 BinairoBoard create_BinairoBoard( FILE* config_file );
 
 
+///
+/// copy_BinairoBoard
+///
+/// create a deep copy of a puzzle board, including which cells are
+/// given and proven
+///
+/// @param board - the board to copy
+///
+/// @return - the copy, to be destroyed with destroy_BinairoBoard
+///
+BinairoBoard copy_BinairoBoard( BinairoBoard board );
+
+
 ///
 /// dim_BinairoBoard
 ///
@@ -74,6 +87,31 @@ int dim_BinairoBoard( BinairoBoard brd );
 bool is_marked_BinairoBoard( BinairoBoard board, int cell );
 
 
+///
+/// prove_BinairoBoard
+///
+/// flag a cell whose digit was proven by propagation, i.e. it holds
+/// that digit in every solution of the puzzle
+///
+/// @param board - the binairo board
+/// @param cell - the proven cell
+///
+void prove_BinairoBoard( BinairoBoard board, int cell );
+
+
+///
+/// is_proven_BinairoBoard
+///
+/// determine if a cell's digit was proven by propagation
+///
+/// @param board - the binairo board
+/// @param cell - the cell spot to check
+///
+/// @return - true if the cell was proven; otherwise, false
+///
+bool is_proven_BinairoBoard( BinairoBoard board, int cell );
+
+
 ///
 /// put_BinairoBoard
 ///
@@ -86,6 +124,30 @@ bool is_marked_BinairoBoard( BinairoBoard board, int cell );
 void put_BinairoBoard( BinairoBoard board, int cell, Digit digit );
 
 
+///
+/// give_BinairoBoard
+///
+/// make a cell one of the puzzle's givens, or with BLANK, no longer
+/// a given; the cell is no longer flagged as proven
+///
+/// @param board - the binairo board
+/// @param cell - the cell to change
+/// @param digit - the given digit, or BLANK to remove it
+///
+void give_BinairoBoard( BinairoBoard board, int cell, Digit digit );
+
+
+///
+/// clear_BinairoBoard
+///
+/// blank every cell that is not given and clear the proven flags,
+/// leaving only the puzzle
+///
+/// @param board - the binairo board
+///
+void clear_BinairoBoard( BinairoBoard board );
+
+
 ///
 /// get_BinairoBoard
 ///
@@ -137,6 +199,19 @@ int numberof_column_BinairoBoard( BinairoBoard board, int column, Digit digit );
 void print_BinairoBoard( BinairoBoard board, FILE* stream );
 
 
+///
+/// stream_BinairoBoard
+///
+/// writes the board in the format of a configuration file, its
+/// dimension and then a row of digits per line, which stays compact
+/// for boards too large to pretty print
+///
+/// @param board - the board to write out
+/// @param stream - the stream to write to
+///
+void stream_BinairoBoard( BinairoBoard board, FILE* stream );
+
+
 ///
 /// destroy_BinairoBoard
 ///
@@ -17,35 +17,111 @@
 #define _DEFAULT_SOURCE
 #include <assert.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "binairo_board.h"
 #include "binairo_bt.h"
+#include "binairo_cdcl.h"
+#include "binairo_check.h"
+#include "binairo_large.h"
+#include "binairo_memo.h"
+#include "binairo_perf.h"
 #include "display.h"
 #include "hash_info.h"
 
-#define BLANK printf( "       " )
-#define DEBUG_TRUE if( debug ) { set_cur_pos( 2*dim+2, 1 ); BLANK; puts( "\rVALID" ); usleep( delay ); }
-#define DEBUG_FALSE if ( debug ) { set_cur_pos( 2*dim+2, 1 ); BLANK; puts( "\rINVALID" ); usleep( delay ); }
-#define DEBUG_BRD if( debug ) { set_cur_pos( 1, 1 ); print_BinairoBoard( brd, stdout ); }
+/// every piece of solver state is kept per thread, so that the solvers
+/// of a portfolio can run side by side, each on its own board
+#define SOLVER_LOCAL __thread
+
+#define BLANK_LINE printf( "       " )
+#define DEBUG_TRUE if( debug ) { set_cur_pos( 2*dim+2, 1 ); BLANK_LINE; puts( "\rVALID" ); usleep( delay ); }
+#define DEBUG_FALSE if ( debug ) { set_cur_pos( 2*dim+2, 1 ); BLANK_LINE; puts( "\rINVALID" ); usleep( delay ); }
+#define DEBUG_BRD if( debug ) { sync_board( ); set_cur_pos( 1, 1 ); print_BinairoBoard( brd, stdout ); }
 
 
 /// the binairo board to be solved
-static BinairoBoard brd = NULL;
+static SOLVER_LOCAL BinairoBoard brd = NULL;
 
 /// dimension of the board
-static int dim = 0;
+static SOLVER_LOCAL int dim = 0;
 
 /// graphics debugging
-static bool debug = false;
+static SOLVER_LOCAL bool debug = false;
 
 /// hash info for checking duplicate rows and columns
-static HashInfo hashinfo = NULL;
+static SOLVER_LOCAL HashInfo hashinfo = NULL;
 
 /// delay for printing board in debug mode
-static double delay = 1000000;
+static SOLVER_LOCAL double delay = 1000000;
+
+/// flat copy of the board the kernels search on, one Digit per cell
+static SOLVER_LOCAL char* grid = NULL;
+
+/// is the cell fixed before the search, either given by the initial
+/// board or proven by propagation
+static SOLVER_LOCAL bool* fixed = NULL;
+
+/// number of each digit in every row and column, indexed [digit][line]
+static SOLVER_LOCAL int* row_count[2] = { NULL, NULL };
+static SOLVER_LOCAL int* col_count[2] = { NULL, NULL };
+
+/// bits of the filled cells and of the cells holding ONE in every row
+/// and column, indexed [direction][line] with the first cell highest;
+/// kept only for boards whose lines fit the line memo
+static SOLVER_LOCAL uint64_t* line_filled[2] = { NULL, NULL };
+static SOLVER_LOCAL uint64_t* line_ones[2] = { NULL, NULL };
+
+/// limits on the current search
+static SOLVER_LOCAL SolveOptions limits = { .cancel = NULL };
+
+/// monotonic time at which the search gives up
+static SOLVER_LOCAL struct timespec stop_time;
+
+/// number of search nodes visited
+static SOLVER_LOCAL unsigned long nodes = 0;
+
+/// node count at which the limits are checked next
+static SOLVER_LOCAL unsigned long next_check = 0;
+
+/// set once a limit is hit, which unwinds the search
+static SOLVER_LOCAL bool interrupted = false;
+
+/// node count at which the current restart ends
+static SOLVER_LOCAL unsigned long restart_at = 0;
+
+/// set when the current restart ran out of nodes, rather than a limit
+static SOLVER_LOCAL bool restarting = false;
+
+/// deepest partial board reached by the search, and its depth
+static SOLVER_LOCAL char* best = NULL;
+static SOLVER_LOCAL int best_depth = -1;
+
+/// order in which the search visits the cells, indexed by depth
+static SOLVER_LOCAL int* order = NULL;
+
+/// state of the random number generator for randomized ordering
+static SOLVER_LOCAL unsigned long long rng = 0;
+
+/// cells assigned by propagation, in order, so they can be undone
+static SOLVER_LOCAL int* trail = NULL;
+static SOLVER_LOCAL int trail_len = 0;
+
+/// digit each cell was implied to hold by the ZERO probe of a cell
+static SOLVER_LOCAL char* implied = NULL;
+
+/// cells touched by a probe, or implied by both of its digits
+static SOLVER_LOCAL int* probed = NULL;
+
+/// flags an implied cell that both digits of a probe agree on
+#define COMMON 4
+
+/// where propagation before the search last found a contradiction
+static SOLVER_LOCAL CheckReport conflict;
 
 
 // initialize the backtracker
@@ -72,304 +148,766 @@ void bt_initialize( BinairoBoard b, bool d, double del ){
 /// static bool is_goal( int area, int status ) { return status == area; }
 
 /// simpler line to check for goal
-#define IS_GOAL dim*dim == status
+#define IS_GOAL dim*dim == depth
 
 
 ///
-/// chk_[left,right,up,down,midrow,midcol]_adj
+/// sync_board
+///
+/// copies the grid the kernels work on back onto the board
 ///
-/// list of functions that validates a digit being
-/// put in a cell on the board by checking the adjacent
-/// cells
+static void sync_board( ){
+    int cell;
+    for( cell=0; cell<dim*dim; cell++ )
+        if( !is_marked_BinairoBoard( brd, cell ) )
+            put_BinairoBoard( brd, cell, (Digit)grid[cell] );
+}
+
+
 ///
-/// @param status - the cell being validated
-/// @param digit - the digit in the cell
+/// schedule_check
 ///
-/// @return - true if digit can be put in that cell; otherwise, false
+/// sets the node count at which the limits are checked next: the next
+/// deadline/cancellation poll, the node limit or the end of the current
+/// restart, whichever comes first; without any of them, the kernels
+/// never stop to check
 ///
-static bool chk_left_adj( int status, Digit digit ){
-    char idx = 2;
-    char count = 0;
-    int cur = status%dim;
-    while( --status >= 0 && status%dim <= cur && idx-- )
-        count += get_BinairoBoard( brd, status ) == digit ? 1 : 0;
-    return count != 2; 
+static void schedule_check( ){
+    next_check = (unsigned long)-1;
+    if( limits.deadline > 0 || limits.cancel != NULL )
+        next_check = nodes + CHECK_INTERVAL;
+    if( limits.max_nodes && limits.max_nodes < next_check )
+        next_check = limits.max_nodes;
+    if( restart_at && restart_at < next_check )
+        next_check = restart_at;
 }
 
-static bool chk_right_adj( int status, Digit digit ){
-    char idx = 2;
-    char count = 0;
-    while( (++status)%dim != 0 && idx-- )
-        count += get_BinairoBoard( brd, status ) == digit ? 1 : 0;
-    return count != 2;
+
+///
+/// out_of_budget
+///
+/// checks the search limits and the restart schedule, then schedules
+/// the next check; called by the kernels only when the node count
+/// reaches next_check, so the clock is read every CHECK_INTERVAL nodes
+///
+/// @return - true if the search should stop; otherwise, false
+///
+static bool out_of_budget( ){
+    if( limits.max_nodes && nodes >= limits.max_nodes )
+        interrupted = true;
+    else if( out_of_time( &limits, &stop_time ) )
+        interrupted = true;
+
+    if( !interrupted && restart_at && nodes >= restart_at )
+        interrupted = restarting = true;
+
+    schedule_check( );
+    return interrupted;
+}
+
+
+///
+/// set_limits
+///
+/// resets the search counters and arms the limits for a new search
+///
+/// @param options - the limits, or NULL for none
+///
+static void set_limits( const SolveOptions* options ){
+    static const SolveOptions none = { .cancel = NULL };
+
+    limits = options != NULL ? *options : none;
+    nodes = 0;
+    interrupted = restarting = false;
+    restart_at = 0;
+    best_depth = -1;
+    rng = limits.seed * 0x9E3779B97F4A7C15ULL + 1;
+
+    if( limits.deadline > 0 )
+        deadline_from( limits.deadline, &stop_time );
 }
 
-static bool chk_up_adj( int status, Digit digit ){
-    char idx = 2;
-    char count = 0;
-    while( (status-=dim) >= 0 && idx-- )
-        count += get_BinairoBoard( brd, status ) == digit ? 1 : 0;  
-    return count != 2;
+
+/// the Luby restart sequence
+unsigned long luby( unsigned long i ){
+    unsigned long k = 1;
+    while( ( 1UL << k ) - 1 < i )
+        k++;
+    if( ( 1UL << k ) - 1 == i )
+        return 1UL << ( k-1 );
+    return luby( i - ( 1UL << ( k-1 ) ) + 1 );
 }
 
-static bool chk_down_adj( int status, Digit digit ){
-    char idx = 2;
-    char count = 0;
-    while( (status+=dim) < dim*dim && idx-- )
-        count += get_BinairoBoard( brd, status ) == digit ? 1 : 0;
-    return count != 2;  
+
+/// step the xorshift64* generator
+unsigned long next_random( unsigned long long* state ){
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return (unsigned long)( ( *state * 2685821657736338717ULL ) >> 32 );
 }
 
-static bool chk_midrow_adj( int status, Digit digit ){
-    char count = 0;
-    int left = status-1;
-    int right = status+1;
-    if( left >= 0 && left%dim < status%dim && get_BinairoBoard( brd, left ) == digit )
-        count++;
-    if( right < dim*dim && right%dim > status%dim && get_BinairoBoard( brd, right ) == digit )
-        count++;
-    return count != 2;
+
+/// the monotonic time some seconds from now
+void deadline_from( double seconds, struct timespec* stop ){
+    clock_gettime( CLOCK_MONOTONIC, stop );
+    stop->tv_sec += (time_t)seconds;
+    stop->tv_nsec += (long)( ( seconds - (time_t)seconds ) * 1e9 );
+    if( stop->tv_nsec >= 1000000000L ){
+        stop->tv_sec++;
+        stop->tv_nsec -= 1000000000L;
+    }
 }
 
-static bool chk_midcol_adj( int status, Digit digit ){
-    char count = 0;
-    int top = status-dim;
-    int bottom = status+dim;
-    if( top >= 0 && get_BinairoBoard( brd, top ) == digit )
-        count++;
-    if( bottom < dim*dim && get_BinairoBoard( brd, bottom ) == digit )
-        count++;
-    return count != 2;
+
+/// check a search's cancellation flag and deadline
+bool out_of_time( const SolveOptions* options, const struct timespec* stop ){
+    struct timespec now;
+
+    if( options->cancel != NULL && atomic_load_explicit( options->cancel, memory_order_relaxed ) )
+        return true;
+    if( options->deadline <= 0 )
+        return false;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return now.tv_sec > stop->tv_sec ||
+           ( now.tv_sec == stop->tv_sec && now.tv_nsec >= stop->tv_nsec );
 }
 
+
 ///
-/// store_hash
+/// shuffle_order
 ///
-/// helper function to store a string's hash value into 
-/// the hash collection
+/// lays out the order the search visits the cells in: row by row, left
+/// to right; with a seed, the rows come in a random order and each row
+/// is walked in a random direction, keeping the cells of a row together
 ///
-/// @param dir - the vector direction, either row or column
-/// @param status - the current row or column
-static void store_hash( Vector dir, int status ){
-	char* str = calloc( dim+1, sizeof( char ) );
-	int idx;
-	
-	for( idx=0; idx<dim; idx++ ){
-		switch( dir ){
-			case ROW:
-				switch( get_BinairoBoard( brd, status-dim+1+idx ) ){
-					case ZERO:
-						str[idx] = '0';
-						break;
-					case ONE:
-						str[idx] = '1';
-						break;
-					default:
-						assert( get_BinairoBoard( brd, status-dim+1+idx ) );
-				}
-				break;
-			case COL:
-				switch( get_BinairoBoard( brd, status-idx*dim ) ){
-					case ZERO:
-						str[dim-idx-1] = '0'; 
-						break;
-					case ONE:
-						str[dim-idx-1] = '1';
-						break;
-					default:
-						assert( get_BinairoBoard( brd, status-idx*dim ) );
-				}	
-		}
-	}
-	str[idx] = '\0';
-
-	put_HashInfo( hashinfo, str, dir, dir == ROW ? status/dim : status%dim );
-	free( str );
-}  
-
-
-
-///
-/// chk_unique_[rows,cols]
-///
-/// checks if each row or column is unique to the other rows or columns
-/// previous to the current
-///
-/// @param status - the current cell spot
-///
-/// @return - true if all rows and columns are unique; otherwise, false
-///
-/// @pre - status should be a spot at an end of a row or a column 
-///
-static bool chk_unique_rows( int status ){
-	// check if at end of row
-	if( status%dim != dim-1 )
-		return true;
-
-	store_hash( ROW, status );
-
-	size_t cur_hash = get_HashInfo( hashinfo, ROW, status/dim );	
-
-	while( (status-=dim) > 0 )
-		if( cur_hash == get_HashInfo( hashinfo, ROW, status/dim ) )
-			return false;	
-
-	return true;
+static void shuffle_order( ){
+    int rows[dim];
+    int r, c, i, tmp;
+
+    for( r=0; r<dim; r++ )
+        rows[r] = r;
+
+    if( limits.seed ){
+        for( r=dim-1; r>0; r-- ){
+            i = (int)( next_random( &rng ) % (unsigned long)( r+1 ) );
+            tmp = rows[r];
+            rows[r] = rows[i];
+            rows[i] = tmp;
+        }
+    }
+
+    for( r=0; r<dim; r++ ){
+        bool reverse = limits.seed && ( next_random( &rng ) & 1 );
+        for( c=0; c<dim; c++ )
+            order[r*dim+c] = rows[r]*dim + ( reverse ? dim-1-c : c );
+    }
+}
+
+
+// failed-literal probing, used by the kernels near the root
+static bool probe( );
+static void undo_to( int mark );
+
+
+// one kernel per common board size, with the dimension as a constant
+#define KERNEL_DIM 6
+#define KERNEL_NAME( name ) name##_6
+#include "binairo_kernel.h"
+#undef KERNEL_NAME
+#undef KERNEL_DIM
+
+#define KERNEL_DIM 8
+#define KERNEL_NAME( name ) name##_8
+#include "binairo_kernel.h"
+#undef KERNEL_NAME
+#undef KERNEL_DIM
+
+#define KERNEL_DIM 10
+#define KERNEL_NAME( name ) name##_10
+#include "binairo_kernel.h"
+#undef KERNEL_NAME
+#undef KERNEL_DIM
+
+#define KERNEL_DIM 12
+#define KERNEL_NAME( name ) name##_12
+#include "binairo_kernel.h"
+#undef KERNEL_NAME
+#undef KERNEL_DIM
+
+#define KERNEL_DIM 14
+#define KERNEL_NAME( name ) name##_14
+#include "binairo_kernel.h"
+#undef KERNEL_NAME
+#undef KERNEL_DIM
+
+// fallback for any other size, using the runtime dimension
+#define KERNEL_NAME( name ) name##_generic
+#include "binairo_kernel.h"
+#undef KERNEL_NAME
+
+
+/// dispatch table from board dimension to its specialized kernel
+static const struct {
+    int dim;
+    bool (*bt_solve)( int depth );
+} kernels[] = {
+    { 6, bt_solve_6 },
+    { 8, bt_solve_8 },
+    { 10, bt_solve_10 },
+    { 12, bt_solve_12 },
+    { 14, bt_solve_14 },
+};
+
+
+///
+/// select_kernel
+///
+/// @return - the backtracking kernel specialized for the board's
+///           dimension, or the generic one if there is none
+///
+static bool (*select_kernel( ))( int ){
+    size_t i;
+    for( i=0; i<sizeof( kernels )/sizeof( kernels[0] ); i++ )
+        if( kernels[i].dim == dim )
+            return kernels[i].bt_solve;
+    return bt_solve_generic;
+}
+
+
+///
+/// load_grid
+///
+/// allocates the grid and counters and fills them from the board
+///
+static void load_grid( ){
+    int cell;
+    Digit d;
+    Vector v;
+
+    grid = malloc( dim*dim * sizeof( char ) );
+    best = malloc( dim*dim * sizeof( char ) );
+    fixed = malloc( dim*dim * sizeof( bool ) );
+    order = malloc( dim*dim * sizeof( int ) );
+    trail = malloc( dim*dim * sizeof( int ) );
+    probed = malloc( dim*dim * sizeof( int ) );
+    implied = malloc( dim*dim * sizeof( char ) );
+    for( d=ZERO; d<=ONE; d++ ){
+        row_count[d] = calloc( dim, sizeof( int ) );
+        col_count[d] = calloc( dim, sizeof( int ) );
+        assert( row_count[d] && col_count[d] );
+    }
+    assert( grid && best && fixed && order && trail && probed && implied );
+    memset( implied, BLANK, dim*dim * sizeof( char ) );
+    trail_len = 0;
+    if( dim <= LINE_MEMO_MAX_DIM )
+        for( v=ROW; v<=COL; v++ ){
+            line_filled[v] = calloc( dim, sizeof( uint64_t ) );
+            line_ones[v] = calloc( dim, sizeof( uint64_t ) );
+            assert( line_filled[v] && line_ones[v] );
+        }
+
+    for( cell=0; cell<dim*dim; cell++ ){
+        d = get_BinairoBoard( brd, cell );
+        grid[cell] = (char)d;
+        fixed[cell] = is_marked_BinairoBoard( brd, cell );
+        if( d != BLANK ){
+            row_count[d][cell/dim]++;
+            col_count[d][cell%dim]++;
+        }
+        if( d != BLANK && dim <= LINE_MEMO_MAX_DIM ){
+            line_filled[ROW][cell/dim] |= (uint64_t)1 << ( dim-1 - cell%dim );
+            line_filled[COL][cell%dim] |= (uint64_t)1 << ( dim-1 - cell/dim );
+            line_ones[ROW][cell/dim] |= (uint64_t)( d == ONE ) << ( dim-1 - cell%dim );
+            line_ones[COL][cell%dim] |= (uint64_t)( d == ONE ) << ( dim-1 - cell/dim );
+        }
+    }
+}
+
+
+///
+/// free_grid
+///
+/// deallocates the grid and counters
+///
+static void free_grid( ){
+    Digit d;
+    for( d=ZERO; d<=ONE; d++ ){
+        free( row_count[d] );
+        free( col_count[d] );
+        row_count[d] = col_count[d] = NULL;
+        free( line_filled[d] );
+        free( line_ones[d] );
+        line_filled[d] = line_ones[d] = NULL;
+    }
+    free( grid );
+    free( best );
+    free( fixed );
+    free( order );
+    free( trail );
+    free( probed );
+    free( implied );
+    grid = best = implied = NULL;
+    fixed = NULL;
+    order = trail = probed = NULL;
 }
 
-static bool chk_unique_cols( int status ){
-    // check if at end of column
-	if( status < dim*dim-dim )
-		return true;
 
-	store_hash( COL, status );
+///
+/// excludes
+///
+/// checks whether a digit is ruled out for a cell by the digits
+/// already around it: it would make three in a row along the
+/// cell's row or column, or its row or column already holds
+/// dim/2 of that digit
+///
+/// @param status - the cell
+/// @param digit - the digit to test
+///
+/// @return - true if the digit cannot go in the cell; otherwise, false
+///
+static bool excludes( int status, Digit digit ){
+    int r = status/dim, c = status%dim;
+    const char* cell = grid + status;
+    char d = (char)digit;
+
+    if( row_count[digit][r] >= dim/2 || col_count[digit][c] >= dim/2 )
+        return true;
 
-	int idx = status%dim;
-	size_t cur_hash = get_HashInfo( hashinfo, COL, idx );
+    if( ( c >= 2 && cell[-1] == d && cell[-2] == d ) ||
+            ( c+2 < dim && cell[1] == d && cell[2] == d ) ||
+            ( c >= 1 && c+1 < dim && cell[-1] == d && cell[1] == d ) )
+        return true;
 
-	while( idx-- > 0 )
-		if( cur_hash == get_HashInfo( hashinfo, COL, idx ) )
-			return false;
+    if( ( r >= 2 && cell[-dim] == d && cell[-2*dim] == d ) ||
+            ( r+2 < dim && cell[dim] == d && cell[2*dim] == d ) ||
+            ( r >= 1 && r+1 < dim && cell[-dim] == d && cell[dim] == d ) )
+        return true;
 
-	return true;
+    return false;
 }
 
 
 ///
-/// is_valid
+/// set_conflict
+///
+/// records where propagation found a contradiction
+///
+/// @param dir - direction of the offending line
+/// @param line - the offending line, or -1
+/// @param cell - the offending cell, or -1
+///
+static void set_conflict( Vector dir, int line, int cell ){
+    conflict.rule = PROPAGATION;
+    conflict.dir = dir;
+    conflict.line = line;
+    conflict.other = -1;
+    conflict.cell = cell;
+    conflict.digit = BLANK;
+}
+
+
 ///
-/// when a digit is put on a cell, it would check the following:
-///     if the piece is not at the end of the row:
-///         - check adjacent digits (horizontal and vertical)
-///         - number of 0s == number of 1s in row and col
-///     if cell spot is at end of row:
-///         - check for unique row
-///     if cell spot is at end of column:
-///         - check for unique column
+/// undo_to
 ///
-/// @param status - the cell spot that is being validated
+/// blanks the cells assigned by propagation since the trail had
+/// the given length
 ///
-/// @return true if the digit at cell is valid; otherwise, false
+/// @param mark - the earlier length of the trail
 ///
-static bool is_valid( int status ) { 
-    Digit d = get_BinairoBoard( brd, status );
+static void undo_to( int mark ){
+    while( trail_len > mark )
+        put_generic( trail[--trail_len], BLANK );
+}
+
 
-    // check number of 0s == number of 1s in row
-    if( numberof_row_BinairoBoard( brd, status/dim, ZERO ) > dim/2 || 
-            numberof_row_BinairoBoard( brd, status/dim, ONE ) > dim/2 ){
-        DEBUG_FALSE;
+///
+/// assign
+///
+/// puts a digit on a blank cell, records it on the trail, and checks
+/// the cell's row and column for duplicates if it filled them
+///
+/// @param status - the blank cell
+/// @param digit - the digit
+///
+/// @return - false if the assignment duplicated a line; otherwise, true
+///
+static bool assign( int status, Digit digit ){
+    put_generic( status, digit );
+    trail[trail_len++] = status;
+    return chk_unique_line_generic( ROW, status/dim ) &&
+            chk_unique_line_generic( COL, status%dim );
+}
+
+
+///
+/// propagate_cell
+///
+/// a blank cell with one digit excluded (see excludes) is assigned
+/// the other
+///
+/// @param status - the cell to look at
+///
+/// @return - false if both digits are excluded; otherwise, true
+///
+static bool propagate_cell( int status ){
+    if( grid[status] != BLANK )
+        return true;
+
+    bool no_zero = excludes( status, ZERO );
+    bool no_one = excludes( status, ONE );
+
+    if( no_zero && no_one )
         return false;
-    }
-	// in columns
-    if( numberof_column_BinairoBoard( brd, status%dim, ZERO ) > dim/2 ||
-            numberof_column_BinairoBoard( brd, status%dim, ONE ) > dim/2 ){
-		DEBUG_FALSE;
-		return false;
-    }
+    if( no_zero || no_one )
+        return assign( status, no_zero ? ONE : ZERO );
+    return true;
+}
+
+
+///
+/// propagate_line
+///
+/// assigns every blank cell of a line that the line memo finds to
+/// hold the same digit in all of the line's completions
+///
+/// @param dir - the vector direction, either row or column
+/// @param idx - the row or column number
+///
+/// @return - false if the line cannot be completed or an assignment
+///           duplicated a line; otherwise, true
+///
+static bool propagate_line( Vector dir, int idx ){
+    LineFacts facts;
+    int pos;
 
-    // check adjacency  
-    if( !(  chk_left_adj( status, d ) && 
-        chk_right_adj( status, d ) && 
-        chk_up_adj( status, d ) && 
-        chk_down_adj( status, d ) && 
-        chk_midrow_adj( status, d )  &&
-        chk_midcol_adj( status, d ) )
-    ){
-        DEBUG_FALSE;
+    if( !lookup_LineMemo( dim, line_filled[dir][idx], line_ones[dir][idx], &facts ) )
         return false;
+
+    uint64_t forced = ( facts.zeros | facts.ones ) & ~line_filled[dir][idx];
+    for( pos=0; forced != 0 && pos<dim; pos++ ){
+        uint64_t bit = (uint64_t)1 << ( dim-1-pos );
+        if( !( forced & bit ) )
+            continue;
+        forced &= ~bit;
+        if( !assign( dir == ROW ? idx*dim + pos : pos*dim + idx, facts.ones & bit ? ONE : ZERO ) )
+            return false;
     }
+    return true;
+}
 
-    // at end of row
-    if( !chk_unique_rows( status ) ){
-        DEBUG_FALSE;
-        return false;
-    }   
 
-	// at end of column
-	if( !chk_unique_cols( status ) ){
-		DEBUG_FALSE;
-		return false;
-	}
+///
+/// propagate
+///
+/// unit propagation from the cells on the trail starting at the given
+/// position: each assigned cell may force the blanks within two cells
+/// of it along its row and column, or every blank of its row or column
+/// once that line holds dim/2 of a digit; with the line memo, every
+/// cell its row and column force is assigned instead; the cells this
+/// assigns go on the trail and are propagated in turn
+///
+/// @param from - the first trail position to propagate
+///
+/// @return - false if a contradiction was reached; otherwise, true
+///
+static bool propagate( int from ){
+    int i, k;
+
+    for( i=from; i<trail_len; i++ ){
+        int status = trail[i];
+        int r = status/dim, c = status%dim;
+        Digit d = (Digit)grid[status];
+
+        if( dim <= LINE_MEMO_MAX_DIM ){
+            if( !propagate_line( ROW, r ) || !propagate_line( COL, c ) )
+                return false;
+            continue;
+        }
+
+        for( k=-2; k<=2; k++ ){
+            if( k == 0 )
+                continue;
+            if( c+k >= 0 && c+k < dim && !propagate_cell( status+k ) )
+                return false;
+            if( r+k >= 0 && r+k < dim && !propagate_cell( status+k*dim ) )
+                return false;
+        }
 
-    DEBUG_TRUE;
-    return true;    
+        if( row_count[d][r] == dim/2 )
+            for( k=0; k<dim; k++ )
+                if( !propagate_cell( r*dim+k ) )
+                    return false;
+        if( col_count[d][c] == dim/2 )
+            for( k=0; k<dim; k++ )
+                if( !propagate_cell( k*dim+c ) )
+                    return false;
+    }
+    return true;
 }
 
 
 ///
-/// bt_solve
+/// try_digit
 ///
-/// performs the actual backtracking method
+/// assigns a digit to a blank cell and propagates it; the caller
+/// undoes the trail
 ///
-/// @param status the cell we are currently backtracking
+/// @param status - the blank cell
+/// @param digit - the digit to try
 ///
-/// @return true if backtracker finds a solution; otherwise, false
+/// @return - false if this leads to a contradiction; otherwise, true
 ///
-static bool bt_solve( int status ) {
-    // goal reached
-    if( IS_GOAL )
-        return true;
-    
-    // no solution found
-    if( status < 0 )
+static bool try_digit( int status, Digit digit ){
+    int from = trail_len;
+    if( excludes( status, digit ) || !assign( status, digit ) )
         return false;
-    
-    // check if cell in board is already marked
-    if( is_marked_BinairoBoard( brd, status ) ){
-        if( chk_unique_rows( status ) && chk_unique_cols( status ) )
-			return bt_solve( status+1 );
-	}
-    
-    // lay digits and validate
-    else{
-        Digit i;
-    	for( i=ZERO; i<=ONE; i++ ){
-
-            // put digit in spot
-            put_BinairoBoard( brd, status, i );
-
-            DEBUG_BRD;
-
-            // advance a depth if valid     
-            if( is_valid( status ) && bt_solve( status+1 ) )
-                    return true;
+    return propagate( from );
+}
+
+
+///
+/// probe_cell
+///
+/// failed-literal probing on one blank cell: each digit is tried in
+/// turn and propagated, then undone through the trail; if one digit
+/// leads to a contradiction, the other is forced; if both succeed,
+/// every cell they both assign the same digit is forced
+///
+/// @param status - the blank cell
+/// @param changed - set if a cell was forced
+///
+/// @return - false if both digits lead to a contradiction; otherwise, true
+///
+static bool probe_cell( int status, bool* changed ){
+    int mark = trail_len;
+    int i, n = 0, common = 0;
 
+    // ZERO, remembering what it implies
+    bool zero_ok = try_digit( status, ZERO );
+    if( zero_ok )
+        for( i=mark; i<trail_len; i++ ){
+            implied[trail[i]] = grid[trail[i]];
+            probed[n++] = trail[i];
         }
-       
-        put_BinairoBoard( brd, status, i ); 
-        DEBUG_BRD;
+    undo_to( mark );
+
+    // ONE, flagging what both imply
+    bool one_ok = try_digit( status, ONE );
+    if( zero_ok && one_ok )
+        for( i=mark; i<trail_len; i++ )
+            if( implied[trail[i]] == grid[trail[i]] )
+                implied[trail[i]] |= COMMON;
+    undo_to( mark );
+
+    // keep the common cells, with their digit, and reset the rest
+    for( i=0; i<n; i++ ){
+        if( implied[probed[i]] & COMMON )
+            probed[common++] = probed[i]*2 + ( implied[probed[i]] & ONE );
+        implied[probed[i]] = BLANK;
+    }
+
+    if( !zero_ok && !one_ok )
+        return false;
+
+    if( !zero_ok || !one_ok ){
+        *changed = true;
+        return try_digit( status, zero_ok ? ZERO : ONE );
+    }
+
+    for( i=0; i<common; i++ ){
+        int cell = probed[i] / 2;
+        if( grid[cell] != BLANK )
+            continue;
+        *changed = true;
+        if( !try_digit( cell, (Digit)( probed[i] % 2 ) ) )
+            return false;
     }
-	return false;
+    return true;
 }
 
 
 ///
-/// apply_heuristics
+/// probe
+///
+/// probes every blank cell (see probe_cell) until no cell is forced;
+/// forced cells stay on the trail for the caller to keep or undo
+///
+/// @return - false if the board has no solution; otherwise, true
+///
+static bool probe( ){
+    bool changed = true;
+    int cell;
+
+    while( changed ){
+        changed = false;
+        for( cell=0; cell<dim*dim; cell++ )
+            if( grid[cell] == BLANK && !probe_cell( cell, &changed ) ){
+                set_conflict( ROW, -1, cell );
+                return false;
+            }
+    }
+    return true;
+}
+
+
 ///
-/// will be implemented later if I ever get back to this solver
+/// apply_heuristics
 ///
-static void apply_heuristics( ){}
+/// propagates the puzzle's rules from the initial board: any blank
+/// cell that has one of its digits excluded (see excludes) must hold
+/// the other, and is fixed and proven before the search begins; this
+/// repeats until no cell changes
+///
+/// @return - false if some cell has both digits excluded, so the puzzle
+///           has no solution; otherwise, true
+///
+static bool apply_heuristics( ){
+    bool changed = true;
+    int cell;
+
+    while( changed ){
+        changed = false;
+        for( cell=0; cell<dim*dim; cell++ ){
+            if( grid[cell] != BLANK )
+                continue;
+
+            bool no_zero = excludes( cell, ZERO );
+            bool no_one = excludes( cell, ONE );
+
+            if( no_zero && no_one ){
+                set_conflict( ROW, -1, cell );
+                return false;
+            }
+            if( no_zero || no_one ){
+                put_generic( cell, no_zero ? ONE : ZERO );
+                fixed[cell] = true;
+                changed = true;
+            }
+        }
+    }
+    return true;
+}
 
 
-/// the "main" function for this backtracking 
+/// the "main" function for this backtracking
 bool solve( ) {
+    return solve_bounded( NULL ) == SOLVED;
+}
+
+
+///
+/// chk_root_lines
+///
+/// before the search, stores the hash of every filled row and column
+/// and checks every line's completion (see chk_forced_line), which
+/// also catches duplicate lines among the givens and proven cells
+///
+/// @return - false if some line already breaks the rules; otherwise, true
+///
+static bool chk_root_lines( ){
+    Vector dir;
+    int idx;
+
+    for( dir=ROW; dir<=COL; dir++ )
+        for( idx=0; idx<dim; idx++ )
+            if( !chk_unique_line_generic( dir, idx ) || !chk_forced_line_generic( dir, idx ) ){
+                set_conflict( dir, idx, -1 );
+                return false;
+            }
+    return true;
+}
+
+
+/// solve within the given limits
+SolveResult solve_bounded( const SolveOptions* options ){
+    bool (*kernel)( int ) = select_kernel( );
+    unsigned long run = 0;
+    SolveResult res = GAVE_UP;
+    int cell;
+
     if( brd == NULL ){
         fprintf( stderr, "Error: board has not been initialized for backtracker.\n" );
-        return false;
+        return NO_SOLUTION;
+    }
+
+    // reject broken givens before setting anything up
+    enter_perf( PHASE_VALIDATE );
+    bool consistent = check_BinairoBoard( brd, options != NULL ? options->report : NULL );
+    leave_perf( PHASE_VALIDATE );
+    if( !consistent ){
+        return NO_SOLUTION;
+    }
+
+    // hand the board to the clause-learning solver, if asked
+    if( options != NULL && options->backend == CDCL ){
+        enter_perf( PHASE_SEARCH );
+        res = solve_cdcl( brd, options );
+        leave_perf( PHASE_SEARCH );
+        return res;
+    }
+
+    // lines too long for a single word go to the large-board solver
+    if( dim >= LARGE_MIN_DIM ){
+        enter_perf( PHASE_SEARCH );
+        res = solve_large( brd, options );
+        leave_perf( PHASE_SEARCH );
+        return res;
     }
 
+    enter_perf( PHASE_PROPAGATE );
 	hashinfo = create_HashInfo( dim );
 
-    // apply heuristics on board
-    apply_heuristics( );
+    load_grid( );
+    set_limits( options );
+
+    // apply heuristics on board, and probe if asked; cells forced at
+    // the root are fixed for the whole search
+    if( !apply_heuristics( ) || !chk_root_lines( ) ||
+            ( limits.probe_depth > 0 && !probe( ) ) ){
+        res = NO_SOLUTION;
+        if( limits.report != NULL )
+            *limits.report = conflict;
+    }
+
+    else while( trail_len > 0 )
+        fixed[trail[--trail_len]] = true;
+    leave_perf( PHASE_PROPAGATE );
+
+    // begin at the starting cell, restarting with a new order each
+    // time a restart runs out of nodes
+    enter_perf( PHASE_SEARCH );
+    if( res != NO_SOLUTION ) for( ;; ){
+        run++;
+        restart_at = limits.restart_unit ? nodes + luby( run ) * limits.restart_unit : 0;
+        interrupted = restarting = false;
+        schedule_check( );
+        shuffle_order( );
+
+        if( kernel( 0 ) ){
+            res = SOLVED;
+            break;
+        }
+        if( !restarting ){
+            res = interrupted ? GAVE_UP : NO_SOLUTION;
+            break;
+        }
+    }
 
-    // beginning at the starting cell
-    bool res = bt_solve( 0 );
+    // write the solution, or the deepest partial board, onto the board
+    if( res == GAVE_UP && best_depth >= 0 )
+        memcpy( grid, best, dim*dim * sizeof( char ) );
+    if( res != NO_SOLUTION ){
+        sync_board( );
+        for( cell=0; cell<dim*dim; cell++ )
+            if( fixed[cell] && !is_marked_BinairoBoard( brd, cell ) )
+                prove_BinairoBoard( brd, cell );
+    }
+    free_grid( );
 
 	// done with the hash collection
 	destroy_HashInfo( hashinfo );
+    leave_perf( PHASE_SEARCH );
 
 	return res;
 }
-
-
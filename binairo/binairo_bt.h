@@ -18,8 +18,49 @@
 #ifndef __BINAIRO_BT_H_
 #define __BINAIRO_BT_H_
 
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <time.h>
 #include "binairo_board.h"
+#include "binairo_check.h"
+#include "binairo_cnf.h"
+
+
+/// iterations of a search between checks of its deadline and
+/// cancellation flag
+#define CHECK_INTERVAL 1024
+
+/// outcome of a solve
+/// SOLVED      - the board holds a solution
+/// NO_SOLUTION - the puzzle has no solution
+/// GAVE_UP     - a limit was hit first; the board holds the deepest
+///               partial board reached
+enum SolveResult_e { SOLVED, NO_SOLUTION, GAVE_UP };
+typedef enum SolveResult_e SolveResult;
+
+/// the search behind a solve
+/// BACKTRACK - the backtracker of this module
+/// CDCL      - the clause-learning SAT solver, on the board's encoding
+enum Backend_e { BACKTRACK, CDCL };
+typedef enum Backend_e Backend;
+
+/// limits on a solve, checked periodically inside the search, and
+/// the search strategy; a zero or NULL field means no limit, or the
+/// plain row-major search with ZERO tried before ONE
+typedef struct SolveOptionsStruct {
+    double deadline;                /// wall-clock seconds the search may run
+    unsigned long max_nodes;        /// maximum number of search nodes
+    atomic_int* cancel;             /// the search stops once this is nonzero,
+                                    /// read with relaxed loads from any thread
+    unsigned long seed;             /// seed for randomized value and row ordering
+    unsigned long restart_unit;     /// nodes per unit of the Luby restart sequence
+    int probe_depth;                /// probe failed literals at the root and at
+                                    /// search nodes shallower than this depth
+    CheckReport* report;            /// where the rule broken is stored when the
+                                    /// board is rejected before the search
+    Backend backend;                /// the search to run
+    CardEncoding encoding;          /// the line count encoding of the CDCL backend
+} SolveOptions;
 
 
 ///
@@ -28,6 +69,9 @@
 /// initialize the backtracker for binairo
 /// THIS MUST BE CALLED BEFORE CALLING THE solve FUNCTION
 ///
+/// the backtracker's state is per thread, so each thread may
+/// initialize and solve its own board
+///
 /// @param board - the starting binairo board
 /// @param debug - is debug enabled?
 /// @param delay - time delay for printing solutions to output
@@ -50,6 +94,72 @@ void bt_initialize( BinairoBoard board, bool debug, double delay );
 bool solve( );
 
 
+///
+/// solve_bounded
+///
+/// solve with a wall-clock deadline, a node budget and an external
+/// cancellation flag
+///
+/// after giving up, the board holds the deepest partial board reached,
+/// and the cells proven by propagation are flagged on the board (see
+/// is_proven_BinairoBoard)
+///
+/// @param options - the limits on the search, or NULL for none
+///
+/// @return SOLVED, NO_SOLUTION, or GAVE_UP if a limit was hit first
+///
+SolveResult solve_bounded( const SolveOptions* options );
+
+
+
+///
+/// luby
+///
+/// the Luby restart sequence 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, ..., which
+/// every search backend restarts on
+///
+/// @param i - the restart number, starting at 1
+///
+/// @return - the length of the i-th restart in restart units
+///
+unsigned long luby( unsigned long i );
+
+
+///
+/// next_random
+///
+/// one step of the xorshift64* generator behind the randomized orders
+///
+/// @param state - the generator's state, nonzero; advanced in place
+///
+/// @return - the next pseudo-random number
+///
+unsigned long next_random( unsigned long long* state );
+
+
+///
+/// deadline_from
+///
+/// @param seconds - wall-clock seconds from now
+/// @param stop - where the monotonic time that many seconds from now
+///               is stored
+///
+void deadline_from( double seconds, struct timespec* stop );
+
+
+///
+/// out_of_time
+///
+/// polled by the searches every CHECK_INTERVAL iterations
+///
+/// @param options - the limits
+/// @param stop - when the deadline passes, from deadline_from
+///
+/// @return - true if the search was cancelled, or it has a deadline
+///           and the deadline passed; otherwise, false
+///
+bool out_of_time( const SolveOptions* options, const struct timespec* stop );
+
 
 #endif //__BINAIRO_BT_H_
 
@@ -0,0 +1,700 @@
+///
+/// file:
+///     binairo_cdcl.c
+///
+/// author:
+///     awallien
+///
+/// description:
+///     implementation of the clause-learning solver; a literal is
+///     2*var for the variable and 2*var+1 for its negation, variables
+///     counted from 0, and the first two literals of every clause are
+///     the ones it is watched on
+///
+/// date:
+///     10/19/26
+///
+
+
+#define _DEFAULT_SOURCE
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "binairo_board.h"
+#include "binairo_bt.h"
+#include "binairo_cdcl.h"
+#include "binairo_cnf.h"
+
+
+/// decay of the variable and clause activities after each conflict
+#define VAR_DECAY 0.95
+#define CLAUSE_DECAY 0.999
+
+/// a variable's value: unassigned, or the digit it holds
+#define UNSET -1
+
+/// a clause; the implied literal of a reason clause comes first
+typedef struct ClauseStruct {
+    double activity;                /// bumped when the clause takes part in a conflict
+    int size;                       /// number of literals
+    bool learnt;                    /// learnt from a conflict, and so removable
+    int lits[];                     /// the literals
+} Clause;
+
+/// the clauses watching a literal
+typedef struct WatchListStruct {
+    Clause** clauses;               /// the clauses
+    int size;                       /// number of clauses
+    int cap;                        /// number allocated
+} WatchList;
+
+/// the solver's state
+typedef struct CdclStruct {
+    int vars;                       /// number of variables
+    signed char* value;             /// each variable's value, or UNSET
+    int* level;                     /// decision level each variable was set at
+    Clause** reason;                /// clause that implied each variable, or NULL
+    bool* phase;                    /// last value of each variable
+    char* seen;                     /// marks variables during conflict analysis
+    WatchList* watches;             /// clauses watching each literal
+
+    double* activity;               /// VSIDS score of each variable
+    double var_inc;                 /// amount of the next bump
+    double clause_inc;              /// amount of the next clause bump
+    int* heap;                      /// unassigned variables, highest activity first
+    int* heap_pos;                  /// position of each variable in the heap, or -1
+    int heap_size;                  /// number of variables in the heap
+
+    int* trail;                     /// literals assigned, in order
+    int trail_len;                  /// number of literals assigned
+    int qhead;                      /// first literal of the trail not yet propagated
+    int* trail_lim;                 /// start of each decision level on the trail
+    int levels;                     /// current decision level
+
+    Clause** clauses;               /// every clause given
+    int n_clauses;                  /// number of clauses given
+    Clause** learnts;               /// every clause learnt and kept
+    int n_learnts;                  /// number of learnt clauses
+    int cap_learnts;                /// number allocated
+    double max_learnts;             /// learnt clauses kept before halving them
+
+    int* learnt;                    /// scratch space for the clause being learnt
+    bool unsat;                     /// an empty clause was derived at level 0
+} Cdcl;
+
+
+/// value of a literal: 1 if true, 0 if false, UNSET if unassigned
+static int lit_value( const Cdcl* s, int lit ){
+    int v = s->value[lit >> 1];
+    return v == UNSET ? UNSET : v ^ ( lit & 1 );
+}
+
+
+///
+/// watch
+///
+/// adds a clause to a literal's watch list
+///
+/// @param list - the watch list
+/// @param clause - the clause
+///
+static void watch( WatchList* list, Clause* clause ){
+    if( list->size == list->cap ){
+        list->cap = list->cap ? 2*list->cap : 4;
+        list->clauses = realloc( list->clauses, list->cap * sizeof( Clause* ) );
+        assert( list->clauses );
+    }
+    list->clauses[list->size++] = clause;
+}
+
+
+///
+/// heap_up
+///
+/// moves a variable up the heap past every variable of lower activity
+///
+/// @param s - the solver
+/// @param i - the variable's position in the heap
+///
+static void heap_up( Cdcl* s, int i ){
+    int v = s->heap[i];
+    while( i > 0 && s->activity[s->heap[( i-1 ) / 2]] < s->activity[v] ){
+        s->heap[i] = s->heap[( i-1 ) / 2];
+        s->heap_pos[s->heap[i]] = i;
+        i = ( i-1 ) / 2;
+    }
+    s->heap[i] = v;
+    s->heap_pos[v] = i;
+}
+
+
+///
+/// heap_down
+///
+/// moves a variable down the heap below every variable of higher activity
+///
+/// @param s - the solver
+/// @param i - the variable's position in the heap
+///
+static void heap_down( Cdcl* s, int i ){
+    int v = s->heap[i];
+    for( ;; ){
+        int child = 2*i + 1;
+        if( child >= s->heap_size )
+            break;
+        if( child+1 < s->heap_size && s->activity[s->heap[child+1]] > s->activity[s->heap[child]] )
+            child++;
+        if( s->activity[s->heap[child]] <= s->activity[v] )
+            break;
+        s->heap[i] = s->heap[child];
+        s->heap_pos[s->heap[i]] = i;
+        i = child;
+    }
+    s->heap[i] = v;
+    s->heap_pos[v] = i;
+}
+
+
+/// puts an unassigned variable back in the heap
+static void heap_insert( Cdcl* s, int v ){
+    if( s->heap_pos[v] >= 0 )
+        return;
+    s->heap[s->heap_size] = v;
+    heap_up( s, s->heap_size++ );
+}
+
+
+/// takes the variable of highest activity out of the heap
+static int heap_pop( Cdcl* s ){
+    int v = s->heap[0];
+    s->heap_pos[v] = -1;
+    if( --s->heap_size > 0 ){
+        s->heap[0] = s->heap[s->heap_size];
+        heap_down( s, 0 );
+    }
+    return v;
+}
+
+
+///
+/// bump_var
+///
+/// raises a variable's activity after it took part in a conflict
+///
+/// @param s - the solver
+/// @param v - the variable
+///
+static void bump_var( Cdcl* s, int v ){
+    int i;
+    if( ( s->activity[v] += s->var_inc ) > 1e100 ){
+        for( i=0; i<s->vars; i++ )
+            s->activity[i] *= 1e-100;
+        s->var_inc *= 1e-100;
+    }
+    if( s->heap_pos[v] >= 0 )
+        heap_up( s, s->heap_pos[v] );
+}
+
+
+///
+/// bump_clause
+///
+/// raises a learnt clause's activity after it took part in a conflict
+///
+/// @param s - the solver
+/// @param c - the clause
+///
+static void bump_clause( Cdcl* s, Clause* c ){
+    int i;
+    if( ( c->activity += s->clause_inc ) > 1e20 ){
+        for( i=0; i<s->n_learnts; i++ )
+            s->learnts[i]->activity *= 1e-20;
+        s->clause_inc *= 1e-20;
+    }
+}
+
+
+///
+/// enqueue
+///
+/// makes a literal true
+///
+/// @param s - the solver
+/// @param lit - the literal
+/// @param reason - the clause implying it, or NULL for a decision
+///
+static void enqueue( Cdcl* s, int lit, Clause* reason ){
+    int v = lit >> 1;
+    s->value[v] = !( lit & 1 );
+    s->level[v] = s->levels;
+    s->reason[v] = reason;
+    s->trail[s->trail_len++] = lit;
+}
+
+
+///
+/// new_clause
+///
+/// allocates a clause
+///
+/// @param lits - its literals
+/// @param size - the number of literals
+/// @param learnt - was it learnt?
+///
+/// @return - the clause
+///
+static Clause* new_clause( const int* lits, int size, bool learnt ){
+    Clause* c = malloc( sizeof( Clause ) + size * sizeof( int ) );
+    assert( c );
+    c->activity = 0;
+    c->size = size;
+    c->learnt = learnt;
+    memcpy( c->lits, lits, size * sizeof( int ) );
+    return c;
+}
+
+
+///
+/// add_clause
+///
+/// adds a clause of the formula, before the search: duplicate literals
+/// and literals false at level 0 are dropped, a satisfied clause is
+/// skipped, and a unit clause is assigned at once
+///
+/// @param s - the solver
+/// @param lits - its literals, which may be reordered
+/// @param size - the number of literals
+///
+static void add_clause( Cdcl* s, int* lits, int size ){
+    int i, j, k;
+
+    for( i=j=0; i<size; i++ ){
+        int val = lit_value( s, lits[i] );
+        if( val == 1 )
+            return;
+        if( val == 0 )
+            continue;
+        for( k=0; k<j && lits[k] != lits[i]; k++ )
+            if( lits[k] == ( lits[i] ^ 1 ) )
+                return;
+        if( k == j )
+            lits[j++] = lits[i];
+    }
+
+    if( j == 0 )
+        s->unsat = true;
+    else if( j == 1 )
+        enqueue( s, lits[0], NULL );
+    else{
+        Clause* c = new_clause( lits, j, false );
+        s->clauses[s->n_clauses++] = c;
+        watch( &s->watches[c->lits[0]], c );
+        watch( &s->watches[c->lits[1]], c );
+    }
+}
+
+
+///
+/// propagate
+///
+/// makes every literal implied by the assigned ones true, visiting only
+/// the clauses watching a literal that became false
+///
+/// @param s - the solver
+///
+/// @return - a clause with every literal false, or NULL
+///
+static Clause* propagate( Cdcl* s ){
+    Clause* conflict = NULL;
+
+    while( s->qhead < s->trail_len && conflict == NULL ){
+        int false_lit = s->trail[s->qhead++] ^ 1;
+        WatchList* list = &s->watches[false_lit];
+        int i = 0, j = 0, k;
+
+        while( i < list->size ){
+            Clause* c = list->clauses[i++];
+
+            // keep the false literal second
+            if( c->lits[0] == false_lit ){
+                c->lits[0] = c->lits[1];
+                c->lits[1] = false_lit;
+            }
+            if( lit_value( s, c->lits[0] ) == 1 ){
+                list->clauses[j++] = c;
+                continue;
+            }
+
+            // watch another literal that is not false, if there is one
+            for( k=2; k<c->size; k++ )
+                if( lit_value( s, c->lits[k] ) != 0 )
+                    break;
+            if( k < c->size ){
+                c->lits[1] = c->lits[k];
+                c->lits[k] = false_lit;
+                watch( &s->watches[c->lits[1]], c );
+                continue;
+            }
+
+            // otherwise, the clause is unit or conflicting
+            list->clauses[j++] = c;
+            if( lit_value( s, c->lits[0] ) == 0 ){
+                conflict = c;
+                while( i < list->size )
+                    list->clauses[j++] = list->clauses[i++];
+            }
+            else
+                enqueue( s, c->lits[0], c );
+        }
+        list->size = j;
+    }
+
+    return conflict;
+}
+
+
+///
+/// analyze
+///
+/// learns the first-UIP clause of a conflict: the literals of the
+/// conflict are resolved with their reasons, latest first, until only
+/// one literal of the current level is left
+///
+/// @param s - the solver
+/// @param conflict - the conflicting clause
+/// @param size - where the learnt clause's size is stored
+///
+/// @return - the level to backtrack to
+///
+static int analyze( Cdcl* s, Clause* conflict, int* size ){
+    Clause* c = conflict;
+    int pending = 0, lit = -1, index = s->trail_len - 1;
+    int len = 1, back = 0, i, k;
+
+    do{
+        if( c->learnt )
+            bump_clause( s, c );
+
+        for( k = lit == -1 ? 0 : 1; k<c->size; k++ ){
+            int q = c->lits[k], v = q >> 1;
+            if( s->seen[v] || s->level[v] == 0 )
+                continue;
+            s->seen[v] = 1;
+            bump_var( s, v );
+            if( s->level[v] >= s->levels )
+                pending++;
+            else
+                s->learnt[len++] = q;
+        }
+
+        // the latest literal of the trail in the conflict
+        while( !s->seen[s->trail[index] >> 1] )
+            index--;
+        lit = s->trail[index--];
+        c = s->reason[lit >> 1];
+        s->seen[lit >> 1] = 0;
+        pending--;
+    } while( pending > 0 );
+    s->learnt[0] = lit ^ 1;
+
+    // watch the literal of the highest level after the asserting one
+    for( i=1; i<len; i++ ){
+        s->seen[s->learnt[i] >> 1] = 0;
+        if( s->level[s->learnt[i] >> 1] > back ){
+            back = s->level[s->learnt[i] >> 1];
+            k = s->learnt[1];
+            s->learnt[1] = s->learnt[i];
+            s->learnt[i] = k;
+        }
+    }
+
+    *size = len;
+    return back;
+}
+
+
+///
+/// backtrack
+///
+/// unassigns every literal above a level, saving its value as the
+/// variable's phase
+///
+/// @param s - the solver
+/// @param level - the level to return to
+///
+static void backtrack( Cdcl* s, int level ){
+    int i;
+
+    if( s->levels <= level )
+        return;
+    for( i=s->trail_len-1; i>=s->trail_lim[level]; i-- ){
+        int v = s->trail[i] >> 1;
+        s->phase[v] = s->value[v];
+        s->value[v] = UNSET;
+        s->reason[v] = NULL;
+        heap_insert( s, v );
+    }
+    s->trail_len = s->qhead = s->trail_lim[level];
+    s->levels = level;
+}
+
+
+/// orders learnt clauses by activity, lowest first
+static int by_activity( const void* a, const void* b ){
+    double x = ( *(Clause* const*)a )->activity, y = ( *(Clause* const*)b )->activity;
+    return ( x > y ) - ( x < y );
+}
+
+
+///
+/// reduce_learnts
+///
+/// removes the less active half of the learnt clauses, except binary
+/// clauses and reasons of assigned literals
+///
+/// @param s - the solver
+///
+static void reduce_learnts( Cdcl* s ){
+    int i, j, lit;
+
+    qsort( s->learnts, s->n_learnts, sizeof( Clause* ), by_activity );
+    for( i=0; i<s->n_learnts / 2; i++ ){
+        Clause* c = s->learnts[i];
+        bool locked = s->reason[c->lits[0] >> 1] == c && lit_value( s, c->lits[0] ) == 1;
+        if( c->size > 2 && !locked )
+            c->size = 0;
+    }
+
+    // drop the removed clauses from every watch list, then free them
+    for( lit=0; lit<2*s->vars; lit++ ){
+        WatchList* list = &s->watches[lit];
+        int k, m;
+        for( k=m=0; k<list->size; k++ )
+            if( list->clauses[k]->size > 0 )
+                list->clauses[m++] = list->clauses[k];
+        list->size = m;
+    }
+    for( i=j=0; i<s->n_learnts; i++ ){
+        if( s->learnts[i]->size == 0 )
+            free( s->learnts[i] );
+        else
+            s->learnts[j++] = s->learnts[i];
+    }
+    s->n_learnts = j;
+}
+
+
+///
+/// learn
+///
+/// adds the clause learnt from a conflict, after backtracking, and
+/// asserts its first literal
+///
+/// @param s - the solver
+/// @param size - the clause's size
+///
+static void learn( Cdcl* s, int size ){
+    if( size == 1 ){
+        enqueue( s, s->learnt[0], NULL );
+        return;
+    }
+
+    Clause* c = new_clause( s->learnt, size, true );
+    if( s->n_learnts == s->cap_learnts ){
+        s->cap_learnts = s->cap_learnts ? 2*s->cap_learnts : 64;
+        s->learnts = realloc( s->learnts, s->cap_learnts * sizeof( Clause* ) );
+        assert( s->learnts );
+    }
+    s->learnts[s->n_learnts++] = c;
+    watch( &s->watches[c->lits[0]], c );
+    watch( &s->watches[c->lits[1]], c );
+    bump_clause( s, c );
+    enqueue( s, c->lits[0], c );
+}
+
+
+///
+/// create_cdcl
+///
+/// loads a formula into a new solver
+///
+/// @param cnf - the formula
+///
+/// @return - the solver
+///
+static Cdcl* create_cdcl( Cnf cnf ){
+    Cdcl* s = calloc( 1, sizeof( Cdcl ) );
+    size_t len, i, start;
+    const int* lits = literals_Cnf( cnf, &len );
+    int n = vars_Cnf( cnf ), v;
+
+    assert( s );
+    s->vars = n;
+    s->value = malloc( n * sizeof( signed char ) );
+    s->level = calloc( n, sizeof( int ) );
+    s->reason = calloc( n, sizeof( Clause* ) );
+    s->phase = calloc( n, sizeof( bool ) );
+    s->seen = calloc( n, sizeof( char ) );
+    s->watches = calloc( 2*n, sizeof( WatchList ) );
+    s->activity = calloc( n, sizeof( double ) );
+    s->heap = malloc( n * sizeof( int ) );
+    s->heap_pos = malloc( n * sizeof( int ) );
+    s->trail = malloc( n * sizeof( int ) );
+    s->trail_lim = malloc( ( n+1 ) * sizeof( int ) );
+    s->clauses = malloc( ( clauses_Cnf( cnf ) + 1 ) * sizeof( Clause* ) );
+    s->learnt = malloc( ( n+1 ) * sizeof( int ) );
+    assert( s->value && s->level && s->reason && s->phase && s->seen && s->watches &&
+            s->activity && s->heap && s->heap_pos && s->trail && s->trail_lim &&
+            s->clauses && s->learnt );
+
+    s->var_inc = s->clause_inc = 1;
+    for( v=0; v<n; v++ ){
+        s->value[v] = UNSET;
+        s->heap_pos[v] = -1;
+        heap_insert( s, v );
+    }
+
+    // translate each DIMACS clause into internal literals
+    int* clause = malloc( ( len+1 ) * sizeof( int ) );
+    assert( clause );
+    for( start=i=0; i<len && !s->unsat; i++ ){
+        if( lits[i] != 0 ){
+            int var = abs( lits[i] ) - 1;
+            clause[i-start] = 2*var + ( lits[i] < 0 );
+            continue;
+        }
+        add_clause( s, clause, (int)( i-start ) );
+        start = i+1;
+    }
+    free( clause );
+
+    s->max_learnts = s->n_clauses / 3.0 + 1000;
+    return s;
+}
+
+
+///
+/// destroy_cdcl
+///
+/// frees a solver and its clauses
+///
+/// @param s - the solver
+///
+static void destroy_cdcl( Cdcl* s ){
+    int i;
+
+    for( i=0; i<s->n_clauses; i++ )
+        free( s->clauses[i] );
+    for( i=0; i<s->n_learnts; i++ )
+        free( s->learnts[i] );
+    for( i=0; i<2*s->vars; i++ )
+        free( s->watches[i].clauses );
+    free( s->value );
+    free( s->level );
+    free( s->reason );
+    free( s->phase );
+    free( s->seen );
+    free( s->watches );
+    free( s->activity );
+    free( s->heap );
+    free( s->heap_pos );
+    free( s->trail );
+    free( s->trail_lim );
+    free( s->clauses );
+    free( s->learnts );
+    free( s->learnt );
+    free( s );
+}
+
+
+/// decide a formula
+SolveResult solve_Cnf( Cnf cnf, const SolveOptions* options, bool* model ){
+    SolveOptions none = { .cancel = NULL };
+    Cdcl* s = create_cdcl( cnf );
+    SolveResult res = GAVE_UP;
+    unsigned long decisions = 0, conflicts = 0, run = 1, iterations = 0;
+    unsigned long restart_at = luby( run ) * CDCL_RESTART_UNIT;
+    struct timespec stop;
+    int v;
+
+    if( options == NULL )
+        options = &none;
+    deadline_from( options->deadline, &stop );
+
+    if( s->unsat )
+        res = NO_SOLUTION;
+    else for( ;; ){
+        if( ++iterations % CHECK_INTERVAL == 0 && out_of_time( options, &stop ) )
+            break;
+
+        Clause* conflict = propagate( s );
+        if( conflict != NULL ){
+            int size, back;
+            conflicts++;
+            if( s->levels == 0 ){
+                res = NO_SOLUTION;
+                break;
+            }
+            back = analyze( s, conflict, &size );
+            backtrack( s, back );
+            learn( s, size );
+            s->var_inc /= VAR_DECAY;
+            s->clause_inc /= CLAUSE_DECAY;
+            continue;
+        }
+
+        // restart on the Luby sequence, keeping what was learnt
+        if( conflicts >= restart_at ){
+            backtrack( s, 0 );
+            restart_at = conflicts + luby( ++run ) * CDCL_RESTART_UNIT;
+        }
+        if( s->n_learnts - s->trail_len >= s->max_learnts ){
+            reduce_learnts( s );
+            s->max_learnts *= 1.1;
+        }
+
+        // branch on the most active unassigned variable, with its saved phase
+        v = -1;
+        while( s->heap_size > 0 && s->value[v = heap_pop( s )] != UNSET )
+            v = -1;
+        if( v < 0 ){
+            res = SOLVED;
+            break;
+        }
+        if( options->max_nodes && ++decisions > options->max_nodes )
+            break;
+        s->trail_lim[s->levels++] = s->trail_len;
+        enqueue( s, 2*v + !s->phase[v], NULL );
+    }
+
+    if( res == SOLVED )
+        for( v=0; v<s->vars; v++ )
+            model[v+1] = s->value[v] == 1;
+
+    destroy_cdcl( s );
+    return res;
+}
+
+
+/// solve a board with the clause-learning solver
+SolveResult solve_cdcl( BinairoBoard board, const SolveOptions* options ){
+    Cnf cnf = create_Cnf( board, options != NULL ? options->encoding : SEQUENTIAL_COUNTER );
+    bool* model = malloc( ( vars_Cnf( cnf ) + 1 ) * sizeof( bool ) );
+    int dim = dim_BinairoBoard( board );
+    int cell;
+
+    assert( model );
+    SolveResult res = solve_Cnf( cnf, options, model );
+    if( res == SOLVED )
+        for( cell=0; cell<dim*dim; cell++ )
+            if( !is_marked_BinairoBoard( board, cell ) )
+                put_BinairoBoard( board, cell, model[cell+1] ? ONE : ZERO );
+
+    free( model );
+    destroy_Cnf( cnf );
+    return res;
+}
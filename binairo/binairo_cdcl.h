@@ -0,0 +1,64 @@
+///
+/// file:
+///     binairo_cdcl.h
+///
+/// author:
+///     awallien
+///
+/// description:
+///     a small conflict-driven clause-learning SAT solver, with two
+///     watched literals per clause, VSIDS branching, phase saving and
+///     Luby restarts, used as an alternative backend to the backtracker
+///     for large boards with few givens
+///
+/// date:
+///     10/19/26
+///
+
+
+#ifndef __BINAIRO_CDCL_H_
+#define __BINAIRO_CDCL_H_
+
+#include <stdbool.h>
+#include "binairo_board.h"
+#include "binairo_bt.h"
+#include "binairo_cnf.h"
+
+
+/// conflicts per unit of the Luby restart sequence
+#define CDCL_RESTART_UNIT 100
+
+
+///
+/// solve_Cnf
+///
+/// decides a formula; the node limit of the options bounds the number
+/// of decisions
+///
+/// @param cnf - the formula
+/// @param options - the limits on the search; NULL for none
+/// @param model - where the value of variable v is stored at model[v],
+///                if satisfiable; it holds vars_Cnf( cnf ) + 1 entries
+///
+/// @return - SOLVED if satisfiable, NO_SOLUTION if not, or GAVE_UP if a
+///           limit was hit first
+///
+SolveResult solve_Cnf( Cnf cnf, const SolveOptions* options, bool* model );
+
+
+///
+/// solve_cdcl
+///
+/// solves a board by encoding it with the options' encoding and
+/// deciding the formula; a solution is written onto the board, which
+/// is otherwise left as it was
+///
+/// @param board - the binairo board
+/// @param options - the limits and encoding; NULL for none
+///
+/// @return - SOLVED, NO_SOLUTION, or GAVE_UP if a limit was hit first
+///
+SolveResult solve_cdcl( BinairoBoard board, const SolveOptions* options );
+
+
+#endif //__BINAIRO_CDCL_H_
@@ -0,0 +1,449 @@
+///
+/// file:
+///     binairo_check.c
+///
+/// author:
+///     awallien
+///
+/// description:
+///     implementation of the consistency checks on a board's givens;
+///     the line pattern bound matches each line against a table of
+///     every valid line of the board's dimension, as bit patterns
+///     with the first cell as the highest bit
+///
+/// date:
+///     10/19/26
+///
+
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "binairo_board.h"
+#include "binairo_check.h"
+#include "hash_info.h"
+
+
+///
+/// set_report
+///
+/// stores a broken rule in the report, if there is one
+///
+/// @param report - the report, or NULL
+/// @param rule - the rule broken
+/// @param dir - direction of the offending line
+/// @param line - the offending line, or -1
+/// @param other - the line it duplicates, or -1
+/// @param cell - the offending cell, or -1
+/// @param digit - the digit counted or repeated, or BLANK
+///
+static void set_report( CheckReport* report, CheckRule rule, Vector dir, int line,
+                        int other, int cell, Digit digit ){
+    if( report == NULL )
+        return;
+    report->rule = rule;
+    report->dir = dir;
+    report->line = line;
+    report->other = other;
+    report->cell = cell;
+    report->digit = digit;
+}
+
+
+///
+/// line_cell
+///
+/// @param dim - the board's dimension
+/// @param dir - the vector direction, either row or column
+/// @param idx - the row or column number
+/// @param pos - the position along the line
+///
+/// @return - the cell at that position of the line
+///
+static inline int line_cell( int dim, Vector dir, int idx, int pos ){
+    return dir == ROW ? idx*dim + pos : pos*dim + idx;
+}
+
+
+///
+/// chk_counts
+///
+/// @param board - the binairo board
+/// @param report - where a broken rule is stored, or NULL
+///
+/// @return - false if a line holds more than dim/2 of a digit; otherwise, true
+///
+static bool chk_counts( BinairoBoard board, CheckReport* report ){
+    int dim = dim_BinairoBoard( board );
+    Vector dir;
+    int idx, pos;
+
+    for( dir=ROW; dir<=COL; dir++ )
+        for( idx=0; idx<dim; idx++ ){
+            int count[BLANK+1] = { 0, 0, 0 };
+            for( pos=0; pos<dim; pos++ )
+                count[get_BinairoBoard( board, line_cell( dim, dir, idx, pos ) )]++;
+            if( count[ZERO] > dim/2 || count[ONE] > dim/2 ){
+                set_report( report, LINE_COUNT, dir, idx, -1, -1,
+                            count[ZERO] > dim/2 ? ZERO : ONE );
+                return false;
+            }
+        }
+    return true;
+}
+
+
+///
+/// chk_triples
+///
+/// @param board - the binairo board
+/// @param report - where a broken rule is stored, or NULL
+///
+/// @return - false if a line holds three adjacent identical digits;
+///           otherwise, true
+///
+static bool chk_triples( BinairoBoard board, CheckReport* report ){
+    int dim = dim_BinairoBoard( board );
+    Vector dir;
+    int idx, pos;
+
+    for( dir=ROW; dir<=COL; dir++ )
+        for( idx=0; idx<dim; idx++ )
+            for( pos=0; pos+2<dim; pos++ ){
+                int cell = line_cell( dim, dir, idx, pos );
+                Digit d = get_BinairoBoard( board, cell );
+                if( d != BLANK &&
+                        get_BinairoBoard( board, line_cell( dim, dir, idx, pos+1 ) ) == d &&
+                        get_BinairoBoard( board, line_cell( dim, dir, idx, pos+2 ) ) == d ){
+                    set_report( report, LINE_TRIPLE, dir, idx, -1, cell, d );
+                    return false;
+                }
+            }
+    return true;
+}
+
+
+///
+/// same_filled_lines
+///
+/// @param board - the binairo board
+/// @param dir - the vector direction, either row or column
+/// @param a - a row or column number
+/// @param b - another row or column number
+///
+/// @return - true if both lines are filled and alike; otherwise, false
+///
+static bool same_filled_lines( BinairoBoard board, Vector dir, int a, int b ){
+    int dim = dim_BinairoBoard( board );
+    int pos;
+
+    for( pos=0; pos<dim; pos++ ){
+        Digit d = get_BinairoBoard( board, line_cell( dim, dir, a, pos ) );
+        if( d == BLANK || d != get_BinairoBoard( board, line_cell( dim, dir, b, pos ) ) )
+            return false;
+    }
+    return true;
+}
+
+
+///
+/// chk_filled_duplicates
+///
+/// @param board - the binairo board
+/// @param report - where a broken rule is stored, or NULL
+///
+/// @return - false if two filled lines are alike; otherwise, true
+///
+static bool chk_filled_duplicates( BinairoBoard board, CheckReport* report ){
+    int dim = dim_BinairoBoard( board );
+    Vector dir;
+    int a, b;
+
+    for( dir=ROW; dir<=COL; dir++ )
+        for( a=0; a<dim; a++ )
+            for( b=a+1; b<dim; b++ )
+                if( same_filled_lines( board, dir, a, b ) ){
+                    set_report( report, LINE_DUPLICATE, dir, b, a, -1, BLANK );
+                    return false;
+                }
+    return true;
+}
+
+
+///
+/// add_patterns
+///
+/// adds every valid completion of a line prefix to the table
+///
+/// @param table - the table being built
+/// @param dim - the line length
+/// @param pattern - the prefix, as bits
+/// @param len - the length of the prefix
+/// @param ones - the number of 1s in the prefix
+/// @param run - the length of the run of identical digits ending the prefix
+///
+static void add_patterns( LineTable* table, int dim, unsigned pattern, int len, int ones, int run ){
+    unsigned bit;
+
+    if( len == dim ){
+        table->patterns[table->size++] = pattern;
+        return;
+    }
+
+    for( bit=0; bit<2; bit++ ){
+        int zeros = len - ones;
+        int same = len > 0 && ( pattern & 1 ) == bit;
+
+        if( ( bit ? ones : zeros ) == dim/2 || ( same && run == 2 ) )
+            continue;
+        add_patterns( table, dim, pattern<<1 | bit, len+1, ones + bit, same ? run+1 : 1 );
+    }
+}
+
+
+/// build the table of valid lines
+LineTable create_LineTable( int dim ){
+    LineTable table;
+
+    // the number of lines with dim/2 of each digit bounds the table
+    size_t bound = 1;
+    int i;
+    for( i=1; i<=dim/2; i++ )
+        bound = bound * ( dim/2 + i ) / i;
+
+    table.patterns = malloc( bound * sizeof( unsigned ) );
+    table.size = 0;
+    assert( table.patterns );
+
+    add_patterns( &table, dim, 0, 0, 0, 0 );
+    return table;
+}
+
+
+/// free a table of valid lines
+void destroy_LineTable( LineTable table ){
+    free( table.patterns );
+}
+
+
+/// the table of valid lines last built on a thread, and its length
+typedef struct LineCacheStruct {
+    LineTable table;
+    int dim;
+} LineCache;
+
+/// each thread's cache, also held by cache_key so that it is freed
+/// when the thread exits
+static __thread LineCache* cached = NULL;
+
+/// thread-specific key whose destructor frees a thread's cache
+static pthread_key_t cache_key;
+static pthread_once_t cache_once = PTHREAD_ONCE_INIT;
+
+
+///
+/// free_LineCache
+///
+/// thread-exit destructor of a thread's cache
+///
+/// @param arg - the LineCache
+///
+static void free_LineCache( void* arg ){
+    LineCache* cache = arg;
+    destroy_LineTable( cache->table );
+    free( cache );
+}
+
+
+///
+/// make_cache_key
+///
+/// creates the key of the threads' caches, once per process
+///
+static void make_cache_key( void ){
+    pthread_key_create( &cache_key, free_LineCache );
+}
+
+
+///
+/// cached_LineTable
+///
+/// the table of valid lines of a length, built once per thread for
+/// as long as boards of that dimension keep being checked, since a
+/// batch of small puzzles would otherwise spend much of each check
+/// building it; the table is freed when the thread exits
+///
+/// @param dim - the line length
+///
+/// @return - the table, owned by the cache
+///
+static LineTable cached_LineTable( int dim ){
+    if( cached == NULL ){
+        pthread_once( &cache_once, make_cache_key );
+        cached = calloc( 1, sizeof( LineCache ) );
+        assert( cached );
+        pthread_setspecific( cache_key, cached );
+    }
+    if( cached->dim != dim ){
+        destroy_LineTable( cached->table );
+        cached->table = create_LineTable( dim );
+        cached->dim = dim;
+    }
+    return cached->table;
+}
+
+
+///
+/// line_masks
+///
+/// builds the bits of a line's givens
+///
+/// @param board - the binairo board
+/// @param dir - the vector direction, either row or column
+/// @param idx - the row or column number
+/// @param care - where the bits of the filled cells are stored
+/// @param ones - where the bits of the cells holding ONE are stored
+///
+static void line_masks( BinairoBoard board, Vector dir, int idx, unsigned* care, unsigned* ones ){
+    int dim = dim_BinairoBoard( board );
+    int pos;
+
+    *care = *ones = 0;
+    for( pos=0; pos<dim; pos++ ){
+        Digit d = get_BinairoBoard( board, line_cell( dim, dir, idx, pos ) );
+        *care = *care<<1 | ( d != BLANK );
+        *ones = *ones<<1 | ( d == ONE );
+    }
+}
+
+
+///
+/// chk_patterns
+///
+/// matches each line against the table of valid lines: a line that
+/// matches none has no valid completion, two lines that each match
+/// only the same one must be alike, and the lines of one direction
+/// must between them match at least as many patterns as there are
+/// lines, since no two may be alike
+///
+/// @param board - the binairo board
+/// @param report - where a broken rule is stored, or NULL
+///
+/// @return - false if a rule is broken; otherwise, true
+///
+static bool chk_patterns( BinairoBoard board, CheckReport* report ){
+    int dim = dim_BinairoBoard( board );
+    LineTable table = cached_LineTable( dim );
+    bool* matched = malloc( table.size * sizeof( bool ) );
+    int* single = malloc( dim * sizeof( int ) );
+    bool ok = true;
+    Vector dir;
+    int idx, j, p;
+
+    assert( matched && single );
+
+    for( dir=ROW; ok && dir<=COL; dir++ ){
+        int distinct = 0;
+        for( p=0; p<table.size; p++ )
+            matched[p] = false;
+
+        for( idx=0; ok && idx<dim; idx++ ){
+            unsigned care, ones;
+            int count = 0;
+
+            line_masks( board, dir, idx, &care, &ones );
+            for( p=0; p<table.size; p++ ){
+                if( ( table.patterns[p] & care ) != ones )
+                    continue;
+                if( !matched[p] ){
+                    matched[p] = true;
+                    distinct++;
+                }
+                single[idx] = p;
+                count++;
+            }
+
+            if( count == 0 ){
+                set_report( report, LINE_PATTERN, dir, idx, -1, -1, BLANK );
+                ok = false;
+            }
+            else if( count > 1 )
+                single[idx] = -1;
+
+            for( j=0; ok && j<idx; j++ )
+                if( single[idx] >= 0 && single[j] == single[idx] ){
+                    set_report( report, LINE_DUPLICATE, dir, idx, j, -1, BLANK );
+                    ok = false;
+                }
+        }
+
+        if( ok && distinct < dim ){
+            set_report( report, LINE_SHORTAGE, dir, -1, -1, -1, BLANK );
+            ok = false;
+        }
+    }
+
+    free( single );
+    free( matched );
+    return ok;
+}
+
+
+/// check the givens of a board
+bool check_BinairoBoard( BinairoBoard board, CheckReport* report ){
+    int dim = dim_BinairoBoard( board );
+
+    set_report( report, CONSISTENT, ROW, -1, -1, -1, BLANK );
+
+    if( dim % 2 != 0 ){
+        set_report( report, ODD_DIMENSION, ROW, -1, -1, -1, BLANK );
+        return false;
+    }
+
+    return chk_counts( board, report ) &&
+            chk_triples( board, report ) &&
+            chk_filled_duplicates( board, report ) &&
+            ( dim > LINE_TABLE_MAX || chk_patterns( board, report ) );
+}
+
+
+/// print where a board broke a rule
+void print_CheckReport( const CheckReport* report, int dim, FILE* stream ){
+    const char* line = report->dir == ROW ? "row" : "column";
+    int r = report->cell / dim + 1, c = report->cell % dim + 1;
+
+    switch( report->rule ){
+        case CONSISTENT:
+            fprintf( stream, "No broken rule was found.\n" );
+            break;
+        case ODD_DIMENSION:
+            fprintf( stream, "The dimension of the board is odd.\n" );
+            break;
+        case LINE_COUNT:
+            fprintf( stream, "Too many %ds in %s %d.\n", report->digit, line, report->line+1 );
+            break;
+        case LINE_TRIPLE:
+            fprintf( stream, "Three adjacent %ds in %s %d, from row %d, column %d.\n",
+                     report->digit, line, report->line+1, r, c );
+            break;
+        case LINE_DUPLICATE:
+            fprintf( stream, "The only completion of %s %d is the same as %s %d.\n",
+                     line, report->line+1, line, report->other+1 );
+            break;
+        case LINE_PATTERN:
+            fprintf( stream, "No valid completion of %s %d.\n", line, report->line+1 );
+            break;
+        case LINE_SHORTAGE:
+            fprintf( stream, "Too few valid completions for every %s to differ.\n", line );
+            break;
+        case PROPAGATION:
+            if( report->cell >= 0 )
+                fprintf( stream, "Contradiction at row %d, column %d, found by propagation.\n", r, c );
+            else
+                fprintf( stream, "Contradiction in %s %d, found by propagation.\n", line, report->line+1 );
+            break;
+    }
+}
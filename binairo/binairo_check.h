@@ -0,0 +1,124 @@
+///
+/// file:
+///     binairo_check.h
+///
+/// author:
+///     awallien
+///
+/// description:
+///     consistency checks on the givens of a binairo board, run
+///     before the search so that most unsolvable puzzles are rejected
+///     without backtracking, along with the rule each one broke
+///
+/// date:
+///     10/19/26
+///
+
+
+#ifndef __BINAIRO_CHECK_H_
+#define __BINAIRO_CHECK_H_
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "binairo_board.h"
+#include "hash_info.h"
+
+
+/// largest dimension for which the table of valid line patterns is
+/// built; larger boards skip the pattern bound
+#define LINE_TABLE_MAX 20
+
+
+/// every valid line of one dimension, as bit patterns with the first
+/// cell as the highest bit, in increasing order
+typedef struct LineTableStruct {
+    unsigned* patterns;             /// every valid line
+    int size;                       /// number of valid lines
+} LineTable;
+
+
+/// rule broken by an unsolvable board
+/// CONSISTENT      - no rule was found broken
+/// ODD_DIMENSION   - no line of odd length has as many 0s as 1s
+/// LINE_COUNT      - a line holds more than dim/2 of a digit
+/// LINE_TRIPLE     - a line holds three adjacent identical digits
+/// LINE_DUPLICATE  - two lines are filled, or forced, alike
+/// LINE_PATTERN    - no valid line pattern agrees with a line's givens
+/// LINE_SHORTAGE   - fewer valid patterns agree with the lines of one
+///                   direction than there are lines, so they cannot
+///                   all differ
+/// PROPAGATION     - propagating the rules from the givens gives a
+///                   cell no possible digit
+enum CheckRule_e { CONSISTENT, ODD_DIMENSION, LINE_COUNT, LINE_TRIPLE,
+                   LINE_DUPLICATE, LINE_PATTERN, LINE_SHORTAGE, PROPAGATION };
+typedef enum CheckRule_e CheckRule;
+
+/// where an unsolvable board broke a rule; fields that do not apply
+/// to the rule are -1
+typedef struct CheckReportStruct {
+    CheckRule rule;                 /// the rule broken
+    Vector dir;                     /// direction of the offending line
+    int line;                       /// the offending row or column
+    int other;                      /// the line it duplicates
+    int cell;                       /// the offending cell
+    Digit digit;                    /// the digit counted or repeated
+} CheckReport;
+
+
+///
+/// check_BinairoBoard
+///
+/// checks the digits on the board, in order, for:
+///     - a line with more than dim/2 of a digit
+///     - three adjacent identical digits
+///     - two filled lines that are alike, or two lines with a single
+///       valid completion that are alike
+///     - a line no valid line pattern agrees with, or a direction with
+///       fewer agreeing patterns than lines
+///
+/// the pattern checks are only run up to LINE_TABLE_MAX
+///
+/// @param board - the binairo board
+/// @param report - where the first broken rule is stored; may be NULL
+///
+/// @return - false if a rule is broken, so the board has no solution;
+///           otherwise, true
+///
+bool check_BinairoBoard( BinairoBoard board, CheckReport* report );
+
+
+///
+/// create_LineTable
+///
+/// builds the table of every line of a dimension with as many 0s as
+/// 1s and no three adjacent identical digits
+///
+/// @param dim - the line length, at most LINE_TABLE_MAX
+///
+/// @return - the table, to be freed with destroy_LineTable
+///
+LineTable create_LineTable( int dim );
+
+
+///
+/// destroy_LineTable
+///
+/// @param table - the table to be freed
+///
+void destroy_LineTable( LineTable table );
+
+
+///
+/// print_CheckReport
+///
+/// prints which rule a board broke and where, with rows and columns
+/// numbered from 1
+///
+/// @param report - the report from a failed check
+/// @param dim - the dimension of the board checked
+/// @param stream - the stream to print to
+///
+void print_CheckReport( const CheckReport* report, int dim, FILE* stream );
+
+
+#endif //__BINAIRO_CHECK_H_
@@ -0,0 +1,282 @@
+///
+/// file:
+///     binairo_cnf.c
+///
+/// author:
+///     awallien
+///
+/// description:
+///     implementation of the CNF encoder; clauses are appended to one
+///     array of literals, each ended by a 0
+///
+/// date:
+///     10/19/26
+///
+
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "binairo_board.h"
+#include "binairo_cnf.h"
+
+
+/// data structure for a formula
+struct CnfStruct {
+    int* lits;                      /// the clauses, each ended by a 0
+    size_t len;                     /// number of integers used
+    size_t cap;                     /// number of integers allocated
+    int vars;                       /// number of variables
+    int clauses;                    /// number of clauses
+    int dim;                        /// dimension of the board encoded
+    CardEncoding encoding;          /// encoding of the line counts
+};
+
+
+///
+/// add_lit
+///
+/// appends a literal, or the 0 ending a clause
+///
+/// @param cnf - the formula
+/// @param lit - the literal
+///
+static void add_lit( Cnf cnf, int lit ){
+    if( cnf->len == cnf->cap ){
+        cnf->cap *= 2;
+        cnf->lits = realloc( cnf->lits, cnf->cap * sizeof( int ) );
+        assert( cnf->lits );
+    }
+    cnf->lits[cnf->len++] = lit;
+    if( lit == 0 )
+        cnf->clauses++;
+}
+
+
+/// appends a clause of one, two or three literals
+static void clause1( Cnf cnf, int a ){ add_lit( cnf, a ); add_lit( cnf, 0 ); }
+static void clause2( Cnf cnf, int a, int b ){ add_lit( cnf, a ); clause1( cnf, b ); }
+static void clause3( Cnf cnf, int a, int b, int c ){ add_lit( cnf, a ); clause2( cnf, b, c ); }
+
+
+///
+/// at_most_sequential
+///
+/// at most k of the literals are true, with Sinz's sequential counter:
+/// s[i][j] holds once j of the first i+1 literals are true
+///
+/// @param cnf - the formula
+/// @param x - the literals
+/// @param n - the number of literals
+/// @param k - the bound, at least 1
+///
+static void at_most_sequential( Cnf cnf, const int* x, int n, int k ){
+    int s[n][k];
+    int i, j;
+
+    for( i=0; i<n-1; i++ )
+        for( j=0; j<k; j++ )
+            s[i][j] = ++cnf->vars;
+
+    clause2( cnf, -x[0], s[0][0] );
+    for( j=1; j<k; j++ )
+        clause1( cnf, -s[0][j] );
+
+    for( i=1; i<n-1; i++ ){
+        clause2( cnf, -x[i], s[i][0] );
+        clause2( cnf, -s[i-1][0], s[i][0] );
+        for( j=1; j<k; j++ ){
+            clause3( cnf, -x[i], -s[i-1][j-1], s[i][j] );
+            clause2( cnf, -s[i-1][j], s[i][j] );
+        }
+        clause2( cnf, -x[i], -s[i-1][k-1] );
+    }
+    clause2( cnf, -x[n-1], -s[n-2][k-1] );
+}
+
+
+///
+/// comparator
+///
+/// sorts two wires of the network, the true one first: the upper
+/// output is the disjunction of the inputs, the lower their conjunction
+///
+/// @param cnf - the formula
+/// @param wire - the wires, of which two are replaced by the outputs
+/// @param a - the upper wire
+/// @param b - the lower wire
+///
+static void comparator( Cnf cnf, int* wire, int a, int b ){
+    int hi = ++cnf->vars, lo = ++cnf->vars;
+
+    clause2( cnf, -wire[a], hi );
+    clause2( cnf, -wire[b], hi );
+    clause3( cnf, -hi, wire[a], wire[b] );
+    clause2( cnf, -lo, wire[a] );
+    clause2( cnf, -lo, wire[b] );
+    clause3( cnf, -wire[a], -wire[b], lo );
+
+    wire[a] = hi;
+    wire[b] = lo;
+}
+
+
+///
+/// exactly_network
+///
+/// exactly k of the literals are true: Batcher's odd-even merge sort,
+/// padded with false wires to a power of two, sorts them so that the
+/// first k outputs are true and the rest false
+///
+/// @param cnf - the formula
+/// @param x - the literals
+/// @param n - the number of literals
+/// @param k - the count, at least 1 and below n
+/// @param false_var - a variable fixed false, for padding
+///
+static void exactly_network( Cnf cnf, const int* x, int n, int k, int false_var ){
+    int m = 1, p, q, i, j;
+
+    while( m < n )
+        m *= 2;
+    int wire[m];
+    for( i=0; i<m; i++ )
+        wire[i] = i < n ? x[i] : false_var;
+
+    for( p=1; p<m; p*=2 )
+        for( q=p; q>=1; q/=2 )
+            for( j=q%p; j+q<m; j+=2*q )
+                for( i=0; i<q && i+j+q<m; i++ )
+                    if( ( i+j ) / ( 2*p ) == ( i+j+q ) / ( 2*p ) )
+                        comparator( cnf, wire, i+j, i+j+q );
+
+    clause1( cnf, wire[k-1] );
+    clause1( cnf, -wire[k] );
+}
+
+
+/// encode a board
+Cnf create_Cnf( BinairoBoard board, CardEncoding encoding ){
+    Cnf cnf = malloc( sizeof( struct CnfStruct ) );
+    int dim = dim_BinairoBoard( board );
+    int dir, line, other, pos, cell;
+    int x[dim], y[dim], neg[dim];
+
+    assert( cnf );
+    cnf->cap = 1024;
+    cnf->len = 0;
+    cnf->lits = malloc( cnf->cap * sizeof( int ) );
+    cnf->vars = dim*dim;
+    cnf->clauses = 0;
+    cnf->dim = dim;
+    cnf->encoding = encoding;
+    assert( cnf->lits );
+
+    // the givens
+    for( cell=0; cell<dim*dim; cell++ ){
+        Digit d = get_BinairoBoard( board, cell );
+        if( d != BLANK )
+            clause1( cnf, d == ONE ? cell+1 : -( cell+1 ) );
+    }
+
+    // an odd line cannot be split in half
+    if( dim % 2 != 0 ){
+        add_lit( cnf, 0 );
+        return cnf;
+    }
+
+    // a variable fixed false pads the sorting networks
+    int false_var = 0;
+    if( encoding == CARDINALITY_NETWORK ){
+        false_var = ++cnf->vars;
+        clause1( cnf, -false_var );
+    }
+
+    for( dir=0; dir<2; dir++ )
+        for( line=0; line<dim; line++ ){
+            for( pos=0; pos<dim; pos++ ){
+                x[pos] = ( dir == 0 ? line*dim + pos : pos*dim + line ) + 1;
+                neg[pos] = -x[pos];
+            }
+
+            // no three alike in a row
+            for( pos=0; pos+2<dim; pos++ ){
+                clause3( cnf, x[pos], x[pos+1], x[pos+2] );
+                clause3( cnf, -x[pos], -x[pos+1], -x[pos+2] );
+            }
+
+            // half of the line is ONE
+            if( encoding == SEQUENTIAL_COUNTER ){
+                at_most_sequential( cnf, x, dim, dim/2 );
+                at_most_sequential( cnf, neg, dim, dim/2 );
+            }
+            else
+                exactly_network( cnf, x, dim, dim/2, false_var );
+
+            // every earlier line of this direction differs somewhere
+            for( other=0; other<line; other++ ){
+                for( pos=0; pos<dim; pos++ ){
+                    int mine = x[pos];
+                    int theirs = ( dir == 0 ? other*dim + pos : pos*dim + other ) + 1;
+                    y[pos] = ++cnf->vars;
+                    clause3( cnf, -y[pos], mine, theirs );
+                    clause3( cnf, -y[pos], -mine, -theirs );
+                }
+                for( pos=0; pos<dim; pos++ )
+                    add_lit( cnf, y[pos] );
+                add_lit( cnf, 0 );
+            }
+        }
+
+    return cnf;
+}
+
+
+/// free a formula
+void destroy_Cnf( Cnf cnf ){
+    assert( cnf );
+    free( cnf->lits );
+    free( cnf );
+}
+
+
+/// number of variables
+int vars_Cnf( Cnf cnf ){
+    assert( cnf );
+    return cnf->vars;
+}
+
+
+/// number of clauses
+int clauses_Cnf( Cnf cnf ){
+    assert( cnf );
+    return cnf->clauses;
+}
+
+
+/// the clauses' literals
+const int* literals_Cnf( Cnf cnf, size_t* len ){
+    assert( cnf );
+    *len = cnf->len;
+    return cnf->lits;
+}
+
+
+/// write a formula in DIMACS
+void write_Cnf( Cnf cnf, FILE* stream ){
+    size_t i;
+
+    assert( cnf );
+    fprintf( stream, "c binairo %dx%d, line counts by %s\n", cnf->dim, cnf->dim,
+             cnf->encoding == SEQUENTIAL_COUNTER ? "sequential counters" : "a cardinality network" );
+    fprintf( stream, "c cell (row r, column c), from 0, is variable r*%d + c + 1, true for 1\n",
+             cnf->dim );
+    fprintf( stream, "p cnf %d %d\n", cnf->vars, cnf->clauses );
+    for( i=0; i<cnf->len; i++ ){
+        if( cnf->lits[i] == 0 )
+            fputs( "0\n", stream );
+        else
+            fprintf( stream, "%d ", cnf->lits[i] );
+    }
+}
@@ -0,0 +1,110 @@
+///
+/// file:
+///     binairo_cnf.h
+///
+/// author:
+///     awallien
+///
+/// description:
+///     encodes a binairo board as a formula in conjunctive normal form,
+///     for the clause-learning backend or for a SAT solver offline in
+///     the DIMACS format
+///
+/// date:
+///     10/19/26
+///
+
+
+#ifndef __BINAIRO_CNF_H_
+#define __BINAIRO_CNF_H_
+
+#include <stddef.h>
+#include <stdio.h>
+#include "binairo_board.h"
+
+
+/// encoding of "half of each line is ONE"
+/// SEQUENTIAL_COUNTER  - at most dim/2 ONEs and at most dim/2 ZEROs, each
+///                       with a sequential counter of dim*dim/2 variables
+/// CARDINALITY_NETWORK - an odd-even merge sorting network over the line,
+///                       whose dim/2-th output is true and next one false
+enum CardEncoding_e { SEQUENTIAL_COUNTER, CARDINALITY_NETWORK };
+typedef enum CardEncoding_e CardEncoding;
+
+/// data structure declaration for a formula
+typedef struct CnfStruct* Cnf;
+
+
+///
+/// create_Cnf
+///
+/// encodes a board: cell i is variable i+1, true for ONE; each given
+/// is a unit clause, each three cells in a row a pair of ternary
+/// clauses, and each pair of rows or columns an auxiliary variable
+/// per position, one of which must mark a difference
+///
+/// @param board - the binairo board
+/// @param encoding - the encoding of the line counts
+///
+/// @return - the formula
+///
+Cnf create_Cnf( BinairoBoard board, CardEncoding encoding );
+
+
+///
+/// destroy_Cnf
+///
+/// frees the formula
+///
+/// @param cnf - the formula
+///
+void destroy_Cnf( Cnf cnf );
+
+
+///
+/// vars_Cnf
+///
+/// @param cnf - the formula
+///
+/// @return - the number of variables
+///
+int vars_Cnf( Cnf cnf );
+
+
+///
+/// clauses_Cnf
+///
+/// @param cnf - the formula
+///
+/// @return - the number of clauses
+///
+int clauses_Cnf( Cnf cnf );
+
+
+///
+/// literals_Cnf
+///
+/// the clauses, one after another, each ended by a 0 as in DIMACS;
+/// variable v is the literal v, and its negation -v
+///
+/// @param cnf - the formula
+/// @param len - where the number of integers is stored
+///
+/// @return - the literals, owned by the formula
+///
+const int* literals_Cnf( Cnf cnf, size_t* len );
+
+
+///
+/// write_Cnf
+///
+/// writes the formula in the DIMACS format, with comments naming the
+/// variables of the cells
+///
+/// @param cnf - the formula
+/// @param stream - the stream to write to
+///
+void write_Cnf( Cnf cnf, FILE* stream );
+
+
+#endif //__BINAIRO_CNF_H_
@@ -0,0 +1,557 @@
+///
+/// file:
+///     binairo_corpus.c
+///
+/// author:
+///     awallien
+///
+/// description:
+///     implementation of the sharded corpus runner; the driver indexes
+///     the corpus, forks the workers, hands out shard numbers through
+///     one pipe per worker and collects finished shards through a pipe
+///     shared by all of them, whose small writes are atomic
+///
+/// date:
+///     10/19/26
+///
+
+
+#define _DEFAULT_SOURCE
+#include <assert.h>
+#include <errno.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "binairo_board.h"
+#include "binairo_bt.h"
+#include "binairo_corpus.h"
+#include "get_line.h"
+
+
+/// how long the driver waits for a shard before checking on the workers
+#define POLL_MSEC 200
+
+/// the message a worker sends once a shard's checkpoint is written
+typedef struct ShardDoneStruct {
+    int worker;                     /// the worker, which is now idle
+    int shard;                      /// the shard finished
+} ShardDone;
+
+/// where each shard starts in the corpus file
+typedef struct CorpusIndexStruct {
+    long* offsets;                  /// file offset of each shard's first puzzle
+    int shards;                     /// number of shards
+    int puzzles;                    /// number of puzzles
+} CorpusIndex;
+
+
+///
+/// is_puzzle_line
+///
+/// @param line - a line of the corpus
+///
+/// @return - false for a blank line or a comment; otherwise, true
+///
+static bool is_puzzle_line( const char* line ){
+    while( *line == ' ' || *line == '\t' || *line == '\r' )
+        line++;
+    return *line != '\0' && *line != '\n' && *line != '#';
+}
+
+
+///
+/// index_corpus
+///
+/// finds where every shard of the corpus starts
+///
+/// @param corpus - the corpus file, at its start
+/// @param shard_size - the number of puzzles per shard
+/// @param index - where the index is stored
+///
+static void index_corpus( FILE* corpus, int shard_size, CorpusIndex* index ){
+    char* line = NULL;
+    size_t size = 0;
+    int capacity = 16;
+    long offset = ftell( corpus );
+
+    index->offsets = malloc( capacity * sizeof( long ) );
+    index->shards = index->puzzles = 0;
+    assert( index->offsets );
+
+    while( get_line( &line, &size, corpus ) != -1 ){
+        if( is_puzzle_line( line ) ){
+            if( index->puzzles % shard_size == 0 ){
+                if( index->shards == capacity ){
+                    capacity *= 2;
+                    index->offsets = realloc( index->offsets, capacity * sizeof( long ) );
+                    assert( index->offsets );
+                }
+                index->offsets[index->shards++] = offset;
+            }
+            index->puzzles++;
+        }
+        offset = ftell( corpus );
+    }
+    free( line );
+}
+
+
+///
+/// shard_path
+///
+/// @param dir - the checkpoint directory
+/// @param shard - the shard
+/// @param suffix - "out" for a finished shard, "tmp" while it is written
+///
+/// @return - the path of the shard's checkpoint, to be freed
+///
+static char* shard_path( const char* dir, int shard, const char* suffix ){
+    size_t len = strlen( dir ) + 32;
+    char* path = malloc( len );
+    assert( path );
+    snprintf( path, len, "%s/shard%06d.%s", dir, shard, suffix );
+    return path;
+}
+
+
+///
+/// parse_puzzle
+///
+/// builds a board from a corpus line
+///
+/// @param line - the dimension, then the cells row by row
+///
+/// @return - the board, or NULL if the line is malformed
+///
+static BinairoBoard parse_puzzle( const char* line ){
+    char* cells;
+    long dim = strtol( line, &cells, 10 );
+    size_t len, i;
+
+    while( *cells == ' ' || *cells == '\t' )
+        cells++;
+    for( len=0; cells[len] == '.' || cells[len] == '0' || cells[len] == '1'; len++ )
+        ;
+    if( dim <= 1 || dim > 1024 || len != (size_t)( dim*dim ) )
+        return NULL;
+
+    // lay the cells out as a configuration file, one row per line
+    size_t text_len = 16 + dim*( dim+1 );
+    char* text = malloc( text_len );
+    assert( text );
+    int n = snprintf( text, text_len, "%ld\n", dim );
+    for( i=0; i<(size_t)dim; i++ ){
+        memcpy( text + n, cells + i*dim, dim );
+        n += dim;
+        text[n++] = '\n';
+    }
+
+    FILE* stream = fmemopen( text, n, "r" );
+    BinairoBoard board = stream != NULL ? create_BinairoBoard( stream ) : NULL;
+    if( stream != NULL )
+        fclose( stream );
+    free( text );
+    return board;
+}
+
+
+///
+/// solve_shard
+///
+/// solves a shard's puzzles and writes their results to its checkpoint,
+/// which only appears under its final name once complete
+///
+/// @param corpus - the corpus file
+/// @param index - where the shards start
+/// @param shard_size - the number of puzzles per shard
+/// @param dir - the checkpoint directory
+/// @param shard - the shard
+/// @param options - the limits on each search
+///
+/// @return - false if the checkpoint could not be written; otherwise, true
+///
+static bool solve_shard( FILE* corpus, const CorpusIndex* index, int shard_size,
+                         const char* dir, int shard, const SolveOptions* options ){
+    static const char* outcome[] = { "solved", "unsolvable", "gave-up" };
+    char* tmp = shard_path( dir, shard, "tmp" );
+    char* out = shard_path( dir, shard, "out" );
+    FILE* results = fopen( tmp, "w" );
+    char* line = NULL;
+    size_t size = 0;
+    int number = shard*shard_size;
+    int last = number + shard_size < index->puzzles ? number + shard_size : index->puzzles;
+    bool ok = results != NULL;
+
+    fseek( corpus, index->offsets[shard], SEEK_SET );
+    while( ok && number < last && get_line( &line, &size, corpus ) != -1 ){
+        if( !is_puzzle_line( line ) )
+            continue;
+        number++;
+
+        BinairoBoard board = parse_puzzle( line );
+        if( board == NULL ){
+            fprintf( results, "%d malformed\n", number );
+            continue;
+        }
+
+        int dim = dim_BinairoBoard( board ), cell;
+        bt_initialize( board, false, 0 );
+        SolveResult res = solve_bounded( options );
+
+        fprintf( results, "%d %s ", number, outcome[res] );
+        for( cell=0; cell<dim*dim; cell++ )
+            putc( ".01"[ ( get_BinairoBoard( board, cell ) + 1 ) % 3 ], results );
+        putc( '\n', results );
+        destroy_BinairoBoard( board );
+    }
+
+    if( results != NULL && fclose( results ) != 0 )
+        ok = false;
+    ok = ok && number == last && rename( tmp, out ) == 0;
+
+    free( line );
+    free( tmp );
+    free( out );
+    return ok;
+}
+
+
+///
+/// run_worker
+///
+/// worker body: solves each shard number read from its command pipe
+/// until the pipe closes, reporting each through the shared pipe
+///
+/// @param path - the corpus file
+/// @param index - where the shards start
+/// @param shard_size - the number of puzzles per shard
+/// @param dir - the checkpoint directory
+/// @param id - the worker's number
+/// @param commands - the worker's command pipe
+/// @param done - the shared pipe of finished shards
+/// @param options - the limits on each search
+///
+/// @return - the worker's exit status
+///
+static int run_worker( const char* path, const CorpusIndex* index, int shard_size,
+                       const char* dir, int id, int commands, int done,
+                       const SolveOptions* options ){
+    FILE* corpus = fopen( path, "r" );
+    ShardDone msg = { .worker = id };
+
+    if( corpus == NULL )
+        return EXIT_FAILURE;
+
+    while( read( commands, &msg.shard, sizeof( msg.shard ) ) == sizeof( msg.shard ) ){
+        if( !solve_shard( corpus, index, shard_size, dir, msg.shard, options ) ){
+            fprintf( stderr, "Error: unable to write the checkpoint of shard %d\n", msg.shard );
+            return EXIT_FAILURE;
+        }
+        if( write( done, &msg, sizeof( msg ) ) != sizeof( msg ) )
+            return EXIT_FAILURE;
+    }
+
+    fclose( corpus );
+    return EXIT_SUCCESS;
+}
+
+
+///
+/// open_checkpoints
+///
+/// makes the checkpoint directory, or checks that the one left by an
+/// earlier run was for the same corpus and shard size
+///
+/// @param dir - the checkpoint directory
+/// @param index - the corpus's index
+/// @param shard_size - the number of puzzles per shard
+///
+/// @return - false if the directory cannot be used; otherwise, true
+///
+static bool open_checkpoints( const char* dir, const CorpusIndex* index, int shard_size ){
+    size_t len = strlen( dir ) + 16;
+    char* manifest = malloc( len );
+    int puzzles, size;
+    bool ok = true;
+    FILE* file;
+
+    assert( manifest );
+    snprintf( manifest, len, "%s/manifest", dir );
+
+    if( mkdir( dir, 0777 ) != 0 && errno != EEXIST ){
+        fprintf( stderr, "Error: unable to make checkpoint directory %s\n", dir );
+        ok = false;
+    }
+    else if( ( file = fopen( manifest, "r" ) ) != NULL ){
+        if( fscanf( file, "%d puzzles %d per shard", &puzzles, &size ) != 2 ||
+            puzzles != index->puzzles || size != shard_size ){
+            fprintf( stderr, "Error: the checkpoints in %s are for another corpus or shard size\n", dir );
+            ok = false;
+        }
+        fclose( file );
+    }
+    else if( ( file = fopen( manifest, "w" ) ) != NULL ){
+        fprintf( file, "%d puzzles %d per shard\n", index->puzzles, shard_size );
+        ok = fclose( file ) == 0;
+    }
+    else
+        ok = false;
+
+    free( manifest );
+    return ok;
+}
+
+
+///
+/// remove_checkpoints
+///
+/// removes every checkpoint and the directory, once merged
+///
+/// @param dir - the checkpoint directory
+/// @param shards - the number of shards
+///
+static void remove_checkpoints( const char* dir, int shards ){
+    size_t len = strlen( dir ) + 16;
+    char* manifest = malloc( len );
+    int shard;
+
+    assert( manifest );
+    for( shard=0; shard<shards; shard++ ){
+        char* out = shard_path( dir, shard, "out" );
+        unlink( out );
+        free( out );
+    }
+    snprintf( manifest, len, "%s/manifest", dir );
+    unlink( manifest );
+    rmdir( dir );
+    free( manifest );
+}
+
+
+///
+/// merge_shard
+///
+/// copies a finished shard's results to stdout
+///
+/// @param dir - the checkpoint directory
+/// @param shard - the shard
+/// @param solved - incremented for every puzzle solved
+///
+static void merge_shard( const char* dir, int shard, int* solved ){
+    char* out = shard_path( dir, shard, "out" );
+    FILE* results = fopen( out, "r" );
+    char* line = NULL;
+    size_t size = 0;
+
+    if( results != NULL ){
+        while( get_line( &line, &size, results ) != -1 ){
+            fputs( line, stdout );
+            if( strstr( line, " solved " ) != NULL )
+                (*solved)++;
+        }
+        fclose( results );
+    }
+    free( line );
+    free( out );
+}
+
+
+/// seconds elapsed since a moment
+static double seconds_since( const struct timespec* start ){
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return ( now.tv_sec - start->tv_sec ) + ( now.tv_nsec - start->tv_nsec ) / 1e9;
+}
+
+
+/// solve a corpus on forked workers
+bool run_corpus( const char* path, int workers, int shard_size, const char* checkpoints,
+                 const SolveOptions* options ){
+    FILE* corpus = fopen( path, "r" );
+    SolveOptions limits = { .cancel = NULL };
+    CorpusIndex index;
+    char* dir;
+    int shard, w;
+
+    if( corpus == NULL ){
+        fprintf( stderr, "Error: %s: No such file or directory\n", path );
+        return false;
+    }
+    if( options != NULL )
+        limits = *options;
+    limits.report = NULL;
+    limits.cancel = NULL;
+
+    index_corpus( corpus, shard_size, &index );
+    fclose( corpus );
+
+    if( checkpoints != NULL )
+        dir = strdup( checkpoints );
+    else{
+        dir = malloc( strlen( path ) + 6 );
+        assert( dir );
+        sprintf( dir, "%s.ckpt", path );
+    }
+    assert( dir );
+
+    if( !open_checkpoints( dir, &index, shard_size ) ){
+        free( index.offsets );
+        free( dir );
+        return false;
+    }
+
+    // shards whose checkpoint survived an earlier run are already done
+    bool* done = calloc( index.shards + 1, sizeof( bool ) );
+    int finished = 0, resumed;
+    assert( done );
+    for( shard=0; shard<index.shards; shard++ ){
+        char* out = shard_path( dir, shard, "out" );
+        done[shard] = access( out, F_OK ) == 0;
+        finished += done[shard];
+        free( out );
+    }
+    resumed = finished;
+
+    // fork the workers, each with its own command pipe
+    if( workers > index.shards - finished )
+        workers = index.shards - finished;
+    int* commands = malloc( ( workers + 1 ) * sizeof( int ) );
+    int* assigned = malloc( ( workers + 1 ) * sizeof( int ) );
+    pid_t* pids = malloc( ( workers + 1 ) * sizeof( pid_t ) );
+    int results[2];
+    bool ok = pipe( results ) == 0;
+    assert( commands && assigned && pids && ok );
+
+    fflush( stdout );
+    fflush( stderr );
+    for( w=0; w<workers; w++ ){
+        int command[2];
+        if( pipe( command ) != 0 || ( pids[w] = fork( ) ) < 0 ){
+            fprintf( stderr, "Error: unable to start worker %d\n", w );
+            exit( EXIT_FAILURE );
+        }
+        if( pids[w] == 0 ){
+            int other;
+            for( other=0; other<w; other++ )
+                close( commands[other] );
+            close( command[1] );
+            close( results[0] );
+            _exit( run_worker( path, &index, shard_size, dir, w, command[0], results[1], &limits ) );
+        }
+        close( command[0] );
+        commands[w] = command[1];
+        assigned[w] = -1;
+    }
+    close( results[1] );
+
+    // hand out the shards as the workers finish them, merging in order
+    struct timespec start;
+    int next = 0, merged = 0, solved = 0, busy = 0, puzzles_done = 0;
+    ShardDone msg;
+    clock_gettime( CLOCK_MONOTONIC, &start );
+
+    for( w=0; w<workers; w++ ){
+        while( done[next] )
+            next++;
+        if( write( commands[w], &next, sizeof( next ) ) == sizeof( next ) ){
+            assigned[w] = next;
+            busy++;
+        }
+        next++;
+    }
+
+    for( ;; ){
+        while( merged < index.shards && done[merged] )
+            merge_shard( dir, merged++, &solved );
+        if( busy == 0 )
+            break;
+
+        // while no shard finishes, look for a worker that died on its shard
+        struct pollfd ready = { .fd = results[0], .events = POLLIN };
+        if( poll( &ready, 1, POLL_MSEC ) <= 0 ){
+            for( w=0; w<workers; w++ ){
+                int status;
+                if( pids[w] <= 0 || waitpid( pids[w], &status, WNOHANG ) != pids[w] )
+                    continue;
+                pids[w] = -1;
+                if( assigned[w] >= 0 ){
+                    fprintf( stderr, "\nError: worker %d died on shard %d\n", w, assigned[w] );
+                    ok = false;
+                    assigned[w] = -1;
+                    busy--;
+                }
+                else if( !WIFEXITED( status ) || WEXITSTATUS( status ) != EXIT_SUCCESS )
+                    ok = false;
+                if( commands[w] >= 0 )
+                    close( commands[w] );
+                commands[w] = -1;
+            }
+            continue;
+        }
+        if( read( results[0], &msg, sizeof( msg ) ) != sizeof( msg ) )
+            break;
+
+        busy--;
+        assigned[msg.worker] = -1;
+        done[msg.shard] = true;
+        finished++;
+        puzzles_done += msg.shard == index.shards - 1 ? index.puzzles - msg.shard*shard_size :
+                                                        shard_size;
+
+        double elapsed = seconds_since( &start );
+        fprintf( stderr, "\rshards %d/%d, %d puzzles in %.1f s, %.0f puzzles/s ",
+                 finished, index.shards, puzzles_done, elapsed,
+                 elapsed > 0 ? puzzles_done / elapsed : 0.0 );
+
+        while( next < index.shards && done[next] )
+            next++;
+        if( next < index.shards &&
+            write( commands[msg.worker], &next, sizeof( next ) ) == sizeof( next ) ){
+            assigned[msg.worker] = next++;
+            busy++;
+        }
+        else{
+            close( commands[msg.worker] );
+            commands[msg.worker] = -1;
+        }
+    }
+
+    // reap the workers
+    for( w=0; w<workers; w++ ){
+        int status;
+        if( commands[w] >= 0 )
+            close( commands[w] );
+        if( pids[w] > 0 && ( waitpid( pids[w], &status, 0 ) < 0 || !WIFEXITED( status ) ||
+                             WEXITSTATUS( status ) != EXIT_SUCCESS ) )
+            ok = false;
+    }
+    close( results[0] );
+    fflush( stdout );
+
+    if( merged == index.shards ){
+        fprintf( stderr, "\nSolved %d of %d puzzles (%d of %d shards resumed).\n",
+                 solved, index.puzzles, resumed, index.shards );
+        remove_checkpoints( dir, index.shards );
+    }
+    else{
+        fprintf( stderr, "\nError: %d of %d shards unfinished; run again to resume from %s\n",
+                 index.shards - finished, index.shards, dir );
+        ok = false;
+    }
+
+    free( done );
+    free( commands );
+    free( assigned );
+    free( pids );
+    free( index.offsets );
+    free( dir );
+    return ok;
+}
@@ -0,0 +1,63 @@
+///
+/// file:
+///     binairo_corpus.h
+///
+/// author:
+///     awallien
+///
+/// description:
+///     regrades a corpus of puzzles on every core by splitting it into
+///     shards solved by forked worker processes, so the solver itself
+///     needs no locking; each finished shard is kept as a checkpoint,
+///     and the results are merged back in the corpus's order
+///
+/// date:
+///     10/19/26
+///
+
+
+#ifndef __BINAIRO_CORPUS_H_
+#define __BINAIRO_CORPUS_H_
+
+#include <stdbool.h>
+#include "binairo_bt.h"
+
+
+/// puzzles per shard, unless given
+#define CORPUS_SHARD_SIZE 1000
+
+
+///
+/// run_corpus
+///
+/// solves every puzzle of a corpus file, one puzzle per line as its
+/// dimension and then its cells row by row ("6 .0.0..1..1.1..."),
+/// where blank lines and lines starting with '#' are skipped
+///
+/// the corpus is split into shards of consecutive puzzles, handed out
+/// to the workers as they finish; a worker writes its shard's results
+/// to a file in the checkpoint directory and reports it through a pipe
+///
+/// the results are printed to stdout in the corpus's order, one line
+/// per puzzle: its number, "solved", "unsolvable" or "gave-up", and
+/// the board reached; progress and throughput go to stderr
+///
+/// after a crash, running again with the same corpus, shard size and
+/// checkpoint directory solves only the shards without a checkpoint;
+/// the directory is removed once every result has been printed
+///
+/// @param path - the corpus file
+/// @param workers - the number of worker processes
+/// @param shard_size - the number of puzzles per shard
+/// @param checkpoints - the checkpoint directory; NULL for the corpus
+///                      file's name followed by ".ckpt"
+/// @param options - the limits on each puzzle's search; NULL for none
+///
+/// @return - false if the corpus or the checkpoints could not be used,
+///           or a worker failed; otherwise, true
+///
+bool run_corpus( const char* path, int workers, int shard_size, const char* checkpoints,
+                 const SolveOptions* options );
+
+
+#endif //__BINAIRO_CORPUS_H_
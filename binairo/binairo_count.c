@@ -0,0 +1,621 @@
+///
+/// file:
+///     binairo_count.c
+///
+/// author:
+///     awallien
+///
+/// description:
+///     implementation of the exact solution counter; the board is cut
+///     into a top and a bottom half of dim/2 rows each, and every way
+///     to fill a half is kept as a record keyed by the half's column
+///     profile, the number of 1s in each column, and the two rows next
+///     to the cut; the record also holds the set of rows the half uses
+///     and the pairs of columns it leaves alike, and counts the orders
+///     of its rows that give the same record
+///
+///     a top and a bottom half make a solution exactly when their
+///     profiles add up to dim/2 in every column, no triple crosses the
+///     cut, no row is in both, and no pair of columns is alike in both;
+///     the records are sorted by key, so only halves whose profiles add
+///     up are paired, and uniqueness is checked once per pair, at the
+///     cut, instead of row by row
+///
+///     every cell that can be deduced from the givens is made a given
+///     first, which leaves few lines for each row of a real puzzle
+///
+/// date:
+///     10/19/26
+///
+
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "binairo_board.h"
+#include "binairo_check.h"
+#include "binairo_count.h"
+#include "binairo_session.h"
+
+
+/// words in the set of rows used; there are 208 valid lines of 12
+#define USED_WORDS 4
+
+/// words in the set of alike column pairs; 12 columns have 66 pairs
+#define ALIKE_WORDS 2
+
+/// bits of a record's key holding the two rows next to the cut
+#define CUT_BITS 16
+
+/// bits of a column's 1s in the profile
+#define PROFILE_BITS 3
+
+/// initial number of records in a half
+#define HALF_INITIAL 4096
+
+/// most memory the records of one half may take; an empty 10x10 half
+/// fits, and boards with more ways to fill a half are too open to count
+#define HALF_MAX_BYTES ( (size_t)3 << 29 )
+
+
+/// the layout of the records, shared by both halves
+typedef struct CounterStruct {
+    int dim;                        /// dimension of the board
+    const LineTable* table;         /// the valid lines
+    int* const* candidates;         /// valid lines agreeing with each row's givens
+    const int* n_candidates;        /// number of candidates for each row
+    int used_words;                 /// words in use of the set of rows used
+    int words;                      /// words of rows used and alike pairs in a record
+    int stride;                     /// words in a record: key, the sets, then the count
+} Counter;
+
+/// every way to fill one half of the board, as records of stride words
+typedef struct HalfStruct {
+    uint64_t* records;              /// the records
+    size_t size;                    /// records in the half
+    size_t capacity;                /// records allocated
+} Half;
+
+/// the filling of one half
+typedef struct FillerStruct {
+    const Counter* counter;         /// the layout
+    Half* half;                     /// where the records go
+    int first;                      /// the row farthest from the cut
+    int step;                       /// +1 or -1, toward the cut
+    int rows[COUNT_MAX_DIM/2];      /// lines placed, from the first row
+    uint64_t used[USED_WORDS];      /// the set of rows used
+} Filler;
+
+/// the work shared by the counting threads
+typedef struct CountJobStruct {
+    pthread_mutex_t lock;           /// guards next
+    size_t next;                    /// next profile of the top half to pair
+    size_t n_profiles;              /// number of profiles of the top half
+    const size_t* profiles;         /// first record of each profile, then the end
+    const Counter* counter;         /// the layout
+    const Half* top;                /// the top half
+    const Half* bottom;             /// the bottom half
+} CountJob;
+
+/// a counting thread
+typedef struct CountTaskStruct {
+    CountJob* job;                  /// the shared work
+    unsigned long long total;       /// solutions counted by this thread
+} CountTask;
+
+
+/// words compared when sorting records; set before each sort
+static int sort_words;
+
+
+///
+/// add_record
+///
+/// adds the half just filled to its records
+///
+/// @param f - the filler
+///
+/// @return - false if the records would pass HALF_MAX_BYTES or cannot
+///           grow; otherwise, true
+///
+static bool add_record( Filler* f ){
+    const Counter* c = f->counter;
+    int dim = c->dim, half = dim/2;
+    unsigned segment[COUNT_MAX_DIM];
+    uint64_t profile = 0;
+    int col, other, row, pair = 0;
+
+    if( f->half->size == f->half->capacity ){
+        size_t most = HALF_MAX_BYTES / ( c->stride * sizeof( uint64_t ) );
+        size_t capacity = f->half->capacity * 2 < most ? f->half->capacity * 2 : most;
+        if( capacity <= f->half->capacity )
+            return false;
+
+        uint64_t* records = realloc( f->half->records, capacity * c->stride * sizeof( uint64_t ) );
+        if( records == NULL )
+            return false;
+        f->half->records = records;
+        f->half->capacity = capacity;
+    }
+    uint64_t* record = f->half->records + f->half->size++ * c->stride;
+    memset( record, 0, c->stride * sizeof( uint64_t ) );
+
+    // each column's digits down the half, and its 1s
+    for( col=0; col<dim; col++ ){
+        segment[col] = 0;
+        for( row=0; row<half; row++ )
+            segment[col] = segment[col]<<1 | ( c->table->patterns[f->rows[row]] >> ( dim-1-col ) & 1 );
+        profile |= (uint64_t)__builtin_popcount( segment[col] ) << ( PROFILE_BITS*col );
+    }
+
+    // the rows next to the cut, stored one up so that 0 is no row
+    record[0] = profile << CUT_BITS | (uint64_t)( f->rows[half-1] + 1 );
+    if( half >= 2 )
+        record[0] |= (uint64_t)( f->rows[half-2] + 1 ) << 8;
+
+    memcpy( record + 1, f->used, c->used_words * sizeof( uint64_t ) );
+    uint64_t* alike = record + 1 + c->used_words;
+    for( col=0; col<dim; col++ )
+        for( other=col+1; other<dim; other++, pair++ )
+            if( segment[col] == segment[other] )
+                alike[pair/64] |= (uint64_t)1 << ( pair%64 );
+
+    record[c->stride-1] = 1;
+    return true;
+}
+
+
+///
+/// fill_half
+///
+/// places every line that can be the next row of the half, with no
+/// triple down a column and no row used twice, and adds a record for
+/// each way to fill it
+///
+/// @param f - the filler
+/// @param depth - the number of rows placed
+///
+/// @return - false if the records ran out of room; otherwise, true
+///
+static bool fill_half( Filler* f, int depth ){
+    const Counter* c = f->counter;
+    const unsigned* patterns = c->table->patterns;
+    unsigned mask = ( 1u << c->dim ) - 1;
+    int row = f->first + depth * f->step, k;
+
+    if( depth == c->dim/2 )
+        return add_record( f );
+
+    for( k=0; k<c->n_candidates[row]; k++ ){
+        int line = c->candidates[row][k];
+        unsigned p = patterns[line];
+
+        if( f->used[line/64] >> ( line%64 ) & 1 )
+            continue;
+        if( depth >= 2 ){
+            unsigned a = patterns[f->rows[depth-2]], b = patterns[f->rows[depth-1]];
+            if( ( a & b & p ) || ( ~( a | b | p ) & mask ) )
+                continue;
+        }
+
+        f->rows[depth] = line;
+        f->used[line/64] |= (uint64_t)1 << ( line%64 );
+        bool room = fill_half( f, depth+1 );
+        f->used[line/64] &= ~( (uint64_t)1 << ( line%64 ) );
+        if( !room )
+            return false;
+    }
+    return true;
+}
+
+
+///
+/// compare_records
+///
+/// orders records by their first sort_words words
+///
+/// @param a - a record
+/// @param b - another record
+///
+/// @return - negative, zero or positive as a sorts before, with or after b
+///
+static int compare_records( const void* a, const void* b ){
+    const uint64_t* x = a;
+    const uint64_t* y = b;
+    int i;
+    for( i=0; i<sort_words; i++ )
+        if( x[i] != y[i] )
+            return x[i] < y[i] ? -1 : 1;
+    return 0;
+}
+
+
+///
+/// sort_half
+///
+/// sorts a half's records by key and merges the records that are alike
+/// but for the order of their rows, adding up their counts; the records
+/// left keep only the memory they need
+///
+/// @param c - the layout
+/// @param h - the half
+///
+static void sort_half( const Counter* c, Half* h ){
+    int stride = c->stride;
+    size_t i, kept = 0;
+
+    sort_words = stride - 1;
+    qsort( h->records, h->size, stride * sizeof( uint64_t ), compare_records );
+
+    for( i=0; i<h->size; i++ ){
+        uint64_t* record = h->records + i*stride;
+        uint64_t* last = h->records + ( kept > 0 ? kept-1 : 0 )*stride;
+        if( kept > 0 && memcmp( last, record, ( stride-1 ) * sizeof( uint64_t ) ) == 0 )
+            last[stride-1] += record[stride-1];
+        else
+            memmove( h->records + kept++ * stride, record, stride * sizeof( uint64_t ) );
+    }
+    h->size = kept;
+
+    // the other half is filled in the memory given back
+    if( kept > 0 ){
+        uint64_t* records = realloc( h->records, kept * stride * sizeof( uint64_t ) );
+        if( records != NULL ){
+            h->records = records;
+            h->capacity = kept;
+        }
+    }
+}
+
+
+///
+/// find_profile
+///
+/// finds the records of a half with a given profile
+///
+/// @param c - the layout
+/// @param h - the half, sorted
+/// @param profile - the profile
+/// @param start - where the first record with the profile is stored
+///
+/// @return - the record after the last with the profile
+///
+static size_t find_profile( const Counter* c, const Half* h, uint64_t profile, size_t* start ){
+    size_t lo = 0, hi = h->size;
+
+    while( lo < hi ){
+        size_t mid = lo + ( hi-lo ) / 2;
+        if( h->records[mid * c->stride] >> CUT_BITS < profile )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    *start = lo;
+
+    hi = h->size;
+    while( lo < hi ){
+        size_t mid = lo + ( hi-lo ) / 2;
+        if( h->records[mid * c->stride] >> CUT_BITS <= profile )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+
+///
+/// fits_cut
+///
+/// @param c - the layout
+/// @param top - the key of a top half
+/// @param bottom - the key of a bottom half
+///
+/// @return - true if no column has a triple across the cut; otherwise, false
+///
+static bool fits_cut( const Counter* c, uint64_t top, uint64_t bottom ){
+    const unsigned* patterns = c->table->patterns;
+    unsigned mask = ( 1u << c->dim ) - 1;
+    int a = ( top >> 8 & 0xFF ) - 1, b = ( top & 0xFF ) - 1;
+    int d = ( bottom >> 8 & 0xFF ) - 1, cut = ( bottom & 0xFF ) - 1;
+    unsigned p;
+
+    // a half of one row has nothing next to its row at the cut
+    if( a >= 0 ){
+        p = patterns[a] & patterns[b] & patterns[cut];
+        if( p || ( ~( patterns[a] | patterns[b] | patterns[cut] ) & mask ) )
+            return false;
+    }
+    if( d >= 0 ){
+        p = patterns[b] & patterns[cut] & patterns[d];
+        if( p || ( ~( patterns[b] | patterns[cut] | patterns[d] ) & mask ) )
+            return false;
+    }
+    return true;
+}
+
+
+///
+/// disjoint
+///
+/// @param x - the rows used and alike pairs of one half
+/// @param y - those of the other half
+/// @param words - words in each
+///
+/// @return - true if the halves share no row and no alike pair; otherwise, false
+///
+static inline bool disjoint( const uint64_t* x, const uint64_t* y, int words ){
+    uint64_t common = 0;
+
+    switch( words ){
+        case 6: common |= x[5] & y[5];  // fall through
+        case 5: common |= x[4] & y[4];  // fall through
+        case 4: common |= x[3] & y[3];  // fall through
+        case 3: common |= x[2] & y[2];  // fall through
+        case 2: common |= x[1] & y[1];  // fall through
+        default: common |= x[0] & y[0];
+    }
+    return common == 0;
+}
+
+
+///
+/// pair_runs
+///
+/// counts the solutions made by pairing a run of top records with a run
+/// of bottom records that fit at the cut
+///
+/// @param top - the first top record
+/// @param n_top - the number of top records
+/// @param bottom - the first bottom record
+/// @param n_bottom - the number of bottom records
+/// @param words - words of rows used and alike pairs in a record
+///
+/// @return - the number of solutions
+///
+static inline unsigned long long pair_runs( const uint64_t* top, size_t n_top,
+                                            const uint64_t* bottom, size_t n_bottom, int words ){
+    int stride = words + 2;
+    unsigned long long total = 0;
+    size_t i, j;
+
+    for( i=0; i<n_top; i++ ){
+        const uint64_t* x = top + i*stride;
+        unsigned long long below = 0;
+        for( j=0; j<n_bottom; j++ ){
+            const uint64_t* y = bottom + j*stride;
+            below += disjoint( x+1, y+1, words ) * y[stride-1];
+        }
+        total += below * x[stride-1];
+    }
+    return total;
+}
+
+
+///
+/// count_pairs
+///
+/// pair_runs with the words of the board's records a constant, so the
+/// pairing loop of each dimension is compiled on its own
+///
+/// @param c - the layout
+/// @param top - the first top record
+/// @param n_top - the number of top records
+/// @param bottom - the first bottom record
+/// @param n_bottom - the number of bottom records
+///
+/// @return - the number of solutions
+///
+static unsigned long long count_pairs( const Counter* c, const uint64_t* top, size_t n_top,
+                                       const uint64_t* bottom, size_t n_bottom ){
+    switch( c->words ){
+        case 2: return pair_runs( top, n_top, bottom, n_bottom, 2 );
+        case 3: return pair_runs( top, n_top, bottom, n_bottom, 3 );
+        case 6: return pair_runs( top, n_top, bottom, n_bottom, 6 );
+        default: return pair_runs( top, n_top, bottom, n_bottom, c->words );
+    }
+}
+
+
+///
+/// run_counter
+///
+/// thread body: takes profiles of the top half from the job until none
+/// are left, and pairs their records with the bottom records whose
+/// profile adds up to dim/2 in every column
+///
+/// @param arg - the CountTask
+///
+/// @return - NULL
+///
+static void* run_counter( void* arg ){
+    CountTask* task = arg;
+    CountJob* job = task->job;
+    const Counter* c = job->counter;
+    const uint64_t* top = job->top->records;
+    const uint64_t* bottom = job->bottom->records;
+    int stride = c->stride, col;
+
+    for( ;; ){
+        pthread_mutex_lock( &job->lock );
+        size_t next = job->next++;
+        pthread_mutex_unlock( &job->lock );
+        if( next >= job->n_profiles )
+            break;
+
+        size_t i = job->profiles[next], end = job->profiles[next+1], lo;
+        uint64_t profile = top[i*stride] >> CUT_BITS, rest = 0;
+        for( col=0; col<c->dim; col++ ){
+            uint64_t ones = profile >> ( PROFILE_BITS*col ) & ( ( 1u << PROFILE_BITS ) - 1 );
+            rest |= ( c->dim/2 - ones ) << ( PROFILE_BITS*col );
+        }
+        size_t hi = find_profile( c, job->bottom, rest, &lo );
+
+        // runs of records with the same rows next to the cut
+        while( i < end ){
+            uint64_t key = top[i*stride];
+            size_t i_end = i, j = lo;
+            while( i_end < end && top[i_end*stride] == key )
+                i_end++;
+
+            while( j < hi ){
+                uint64_t other = bottom[j*stride];
+                size_t j_end = j;
+                while( j_end < hi && bottom[j_end*stride] == other )
+                    j_end++;
+                if( fits_cut( c, key, other ) )
+                    task->total += count_pairs( c, top + i*stride, i_end-i,
+                                                bottom + j*stride, j_end-j );
+                j = j_end;
+            }
+            i = i_end;
+        }
+    }
+    return NULL;
+}
+
+
+///
+/// deduce_givens
+///
+/// makes every cell that can be deduced from the givens a given too;
+/// each one holds its digit in every solution, so the count is the
+/// same, but far fewer lines agree with each row
+///
+/// @param board - the board, which gains the givens
+///
+/// @return - false if the givens have no solution; otherwise, true
+///
+static bool deduce_givens( BinairoBoard board ){
+    BinairoSession session = create_BinairoSession( board );
+    bool consistent = true;
+    Hint next;
+
+    while( consistent && hint_BinairoSession( session, &next ) )
+        consistent = set_given_BinairoSession( session, next.cell, next.digit );
+
+    destroy_BinairoSession( session );
+    return consistent;
+}
+
+
+/// count the solutions of a board
+bool count_BinairoBoard( BinairoBoard board, int threads, unsigned long long* count,
+                         CountStats* stats ){
+    int dim = dim_BinairoBoard( board );
+    int row, pos, p, i;
+    size_t r;
+
+    if( dim > COUNT_MAX_DIM || dim % 2 != 0 )
+        return false;
+    if( threads < 1 )
+        threads = 1;
+
+    // start from every deduction; a contradiction leaves no line for some row
+    BinairoBoard puzzle = copy_BinairoBoard( board );
+    bool consistent = deduce_givens( puzzle );
+
+    LineTable table = create_LineTable( dim );
+    int** candidates = malloc( dim * sizeof( int* ) );
+    int* n_candidates = calloc( dim, sizeof( int ) );
+    assert( candidates && n_candidates );
+
+    // the valid lines that agree with each row's givens
+    for( row=0; row<dim; row++ ){
+        unsigned care = 0, ones = 0;
+        for( pos=0; pos<dim; pos++ ){
+            Digit d = get_BinairoBoard( puzzle, row*dim + pos );
+            care = care<<1 | ( d != BLANK );
+            ones = ones<<1 | ( d == ONE );
+        }
+        candidates[row] = malloc( table.size * sizeof( int ) );
+        assert( candidates[row] );
+        for( p=0; consistent && p<table.size; p++ )
+            if( ( table.patterns[p] & care ) == ones )
+                candidates[row][n_candidates[row]++] = p;
+    }
+
+    Counter counter = { .dim = dim, .table = &table, .candidates = candidates,
+                        .n_candidates = n_candidates };
+    counter.used_words = ( table.size + 63 ) / 64;
+    counter.words = counter.used_words + ( dim*( dim-1 )/2 + 63 ) / 64;
+    counter.stride = counter.words + 2;
+    assert( counter.words <= USED_WORDS + ALIKE_WORDS );
+
+    // the top half is filled down to the cut, the bottom half up to it
+    Half top = { .capacity = HALF_INITIAL }, bottom = { .capacity = HALF_INITIAL };
+    Filler down = { .counter = &counter, .half = &top, .first = 0, .step = 1 };
+    Filler up = { .counter = &counter, .half = &bottom, .first = dim-1, .step = -1 };
+    top.records = malloc( top.capacity * counter.stride * sizeof( uint64_t ) );
+    bottom.records = malloc( bottom.capacity * counter.stride * sizeof( uint64_t ) );
+    assert( top.records && bottom.records );
+
+    // a half with too many ways to fill it leaves the board uncounted
+    bool room = fill_half( &down, 0 );
+    if( room ){
+        sort_half( &counter, &top );
+        room = fill_half( &up, 0 );
+    }
+    if( room )
+        sort_half( &counter, &bottom );
+
+    // the first record of each profile of the top half, which the threads share
+    size_t* profiles = malloc( ( top.size + 1 ) * sizeof( size_t ) );
+    size_t n_profiles = 0;
+    assert( profiles );
+    for( r=0; room && r<top.size; r++ )
+        if( r == 0 || top.records[r*counter.stride] >> CUT_BITS !=
+                      top.records[( r-1 )*counter.stride] >> CUT_BITS )
+            profiles[n_profiles++] = r;
+    profiles[n_profiles] = top.size;
+
+    CountJob job = { .next = 0, .n_profiles = n_profiles, .profiles = profiles,
+                     .counter = &counter, .top = &top, .bottom = &bottom };
+    CountTask* tasks = calloc( threads, sizeof( CountTask ) );
+    pthread_t* ids = calloc( threads, sizeof( pthread_t ) );
+    assert( tasks && ids );
+    pthread_mutex_init( &job.lock, NULL );
+
+    // the profiles are handed out one at a time, so a thread that fails to
+    // start leaves its share to the others, or to this thread if none started
+    int started = 0;
+    for( i=0; i<threads; i++ ){
+        tasks[i].job = &job;
+        if( pthread_create( &ids[i], NULL, run_counter, &tasks[i] ) != 0 )
+            break;
+        started++;
+    }
+    if( started == 0 )
+        run_counter( &tasks[0] );
+
+    *count = started == 0 ? tasks[0].total : 0;
+    for( i=0; i<started; i++ ){
+        pthread_join( ids[i], NULL );
+        *count += tasks[i].total;
+    }
+
+    if( stats != NULL ){
+        stats->states = top.size + bottom.size;
+        stats->bytes = ( top.capacity + bottom.capacity ) * counter.stride * sizeof( uint64_t ) +
+                       ( top.size + 1 ) * sizeof( size_t );
+    }
+
+    pthread_mutex_destroy( &job.lock );
+    for( row=0; row<dim; row++ )
+        free( candidates[row] );
+    free( candidates );
+    free( n_candidates );
+    free( top.records );
+    free( bottom.records );
+    free( profiles );
+    free( tasks );
+    free( ids );
+    destroy_LineTable( table );
+    destroy_BinairoBoard( puzzle );
+    return room;
+}
@@ -0,0 +1,64 @@
+///
+/// file:
+///     binairo_count.h
+///
+/// author:
+///     awallien
+///
+/// description:
+///     counts every solution of a binairo board exactly, by pairing
+///     the ways to fill its top half with the ways to fill its bottom
+///     half, for grading how ambiguous a puzzle is
+///
+/// date:
+///     10/19/26
+///
+
+
+#ifndef __BINAIRO_COUNT_H_
+#define __BINAIRO_COUNT_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "binairo_board.h"
+
+
+/// largest dimension the counter handles
+#define COUNT_MAX_DIM 12
+
+
+/// what a count cost
+typedef struct CountStatsStruct {
+    size_t states;                  /// records kept, over both halves
+    size_t bytes;                   /// memory held by the records
+} CountStats;
+
+
+///
+/// count_BinairoBoard
+///
+/// counts the solutions of the board; each half is filled row by row
+/// from the valid lines that agree with its givens, toward the cut in
+/// the middle, and every way to fill it is a record of its column
+/// profile, its two rows next to the cut, its rows and the pairs of
+/// columns it leaves alike; records alike but for the order of their
+/// rows are merged, and a top and a bottom record whose profiles add
+/// up to dim/2 in every column make a solution if no triple crosses
+/// the cut and they share no row and no alike pair
+///
+/// the profiles of the top half are split among the threads
+///
+/// @param board - the binairo board
+/// @param threads - the number of threads to count with
+/// @param count - where the number of solutions is stored
+/// @param stats - where the records' size is stored; may be NULL
+///
+/// @return - false if the board is larger than COUNT_MAX_DIM or odd, or
+///           so open that a half's records would pass the counter's
+///           memory limit; otherwise, true
+///
+bool count_BinairoBoard( BinairoBoard board, int threads, unsigned long long* count,
+                         CountStats* stats );
+
+
+#endif //__BINAIRO_COUNT_H_
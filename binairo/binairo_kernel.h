@@ -0,0 +1,429 @@
+///
+/// file:
+///     binairo_kernel.h
+///
+/// author:
+///     awallien
+///
+/// description:
+///     template for the validation and backtracking kernel of the
+///     binairo solver; binairo_bt.c includes this file once per
+///     specialized board dimension and once more for the generic
+///     fallback
+///
+///     before including, define:
+///         KERNEL_NAME( name ) - suffixes a function name for this kernel
+///         KERNEL_DIM          - (optional) the constant board dimension;
+///                               if left undefined, the runtime dim is used
+///
+///     the kernel works on the solver's flat grid and counters, so with a
+///     constant dimension every row/column index, stride and line loop is
+///     resolved at compile time
+///
+/// date:
+///     10/19/26
+///
+
+
+#ifdef KERNEL_DIM
+#define dim KERNEL_DIM
+#endif
+
+
+///
+/// put
+///
+/// put a digit on the grid and update the row and column counters
+///
+/// @param status - the cell to put the digit on
+/// @param digit - the digit, possibly BLANK
+///
+static inline void KERNEL_NAME( put )( int status, Digit digit ){
+    int r = status/dim, c = status%dim;
+    Digit old = (Digit)grid[status];
+
+    if( old != BLANK ){
+        row_count[old][r]--;
+        col_count[old][c]--;
+    }
+    if( digit != BLANK ){
+        row_count[digit][r]++;
+        col_count[digit][c]++;
+    }
+    grid[status] = (char)digit;
+
+    // the line masks of the memo, first cell highest
+    if( dim <= LINE_MEMO_MAX_DIM ){
+        uint64_t in_row = (uint64_t)1 << ( dim-1-c ), in_col = (uint64_t)1 << ( dim-1-r );
+        uint64_t filled = digit != BLANK ? ~(uint64_t)0 : 0, one = digit == ONE ? ~(uint64_t)0 : 0;
+        line_filled[ROW][r] = ( line_filled[ROW][r] & ~in_row ) | ( filled & in_row );
+        line_filled[COL][c] = ( line_filled[COL][c] & ~in_col ) | ( filled & in_col );
+        line_ones[ROW][r] = ( line_ones[ROW][r] & ~in_row ) | ( one & in_row );
+        line_ones[COL][c] = ( line_ones[COL][c] & ~in_col ) | ( one & in_col );
+    }
+}
+
+
+///
+/// chk_[row,col]_adj
+///
+/// validates a digit being put in a cell on the board by checking the
+/// two cells on either side of it along its row or column, and the cell
+/// on each side when it sits in the middle
+///
+/// @param status - the cell being validated
+/// @param digit - the digit in the cell
+///
+/// @return - true if digit can be put in that cell; otherwise, false
+///
+static inline bool KERNEL_NAME( chk_row_adj )( int status, char digit ){
+    int c = status%dim;
+    const char* cell = grid + status;
+    if( c >= 2 && cell[-1] == digit && cell[-2] == digit )
+        return false;
+    if( c+2 < dim && cell[1] == digit && cell[2] == digit )
+        return false;
+    if( c >= 1 && c+1 < dim && cell[-1] == digit && cell[1] == digit )
+        return false;
+    return true;
+}
+
+static inline bool KERNEL_NAME( chk_col_adj )( int status, char digit ){
+    int r = status/dim;
+    const char* cell = grid + status;
+    if( r >= 2 && cell[-dim] == digit && cell[-2*dim] == digit )
+        return false;
+    if( r+2 < dim && cell[dim] == digit && cell[2*dim] == digit )
+        return false;
+    if( r >= 1 && r+1 < dim && cell[-dim] == digit && cell[dim] == digit )
+        return false;
+    return true;
+}
+
+
+///
+/// chk_line_memo
+///
+/// looks the row and column of a cell up in the line memo, which
+/// answers whether each can still be completed with as many 0s as 1s
+/// and no three alike in a row
+///
+/// @param status - the cell
+///
+/// @return - true if both lines can be completed; otherwise, false
+///
+static inline bool KERNEL_NAME( chk_line_memo )( int status ){
+    int r = status/dim, c = status%dim;
+    LineFacts facts;
+    return lookup_LineMemo( dim, line_filled[ROW][r], line_ones[ROW][r], &facts ) &&
+            lookup_LineMemo( dim, line_filled[COL][c], line_ones[COL][c], &facts );
+}
+
+
+///
+/// fill_line
+///
+/// builds the bit pattern of a row or column with its blanks
+/// filled in by the given digits, in order
+///
+/// @param dir - the vector direction, either row or column
+/// @param idx - the row or column number
+/// @param fill - the digits for the blanks; the last one is repeated
+/// @param nfill - the number of digits in fill
+///
+/// @return - the line as a bit pattern, first cell as the highest bit
+///
+static size_t KERNEL_NAME( fill_line )( Vector dir, int idx, const Digit* fill, int nfill ){
+    const char* cell = dir == ROW ? grid + idx*dim : grid + idx;
+    int step = dir == ROW ? 1 : dim;
+    size_t pattern = 0;
+    int i, used = 0;
+
+    for( i=0; i<dim; i++, cell+=step ){
+        Digit d = (Digit)*cell;
+        if( d == BLANK ){
+            d = fill[used];
+            if( used < nfill-1 )
+                used++;
+        }
+        pattern = pattern<<1 | ( d == ONE );
+    }
+    return pattern;
+}
+
+
+///
+/// no_triples
+///
+/// checks a completed line, as a bit pattern, for three adjacent
+/// identical digits
+///
+/// @param pattern - the line with the first cell as the highest bit
+///
+/// @return - true if no digit appears three times in a row; otherwise, false
+///
+static inline bool KERNEL_NAME( no_triples )( size_t pattern ){
+    size_t mask = dim < 64 ? ( (size_t)1 << dim ) - 1 : ~(size_t)0;
+    size_t inv = ~pattern & mask;
+    size_t keep = mask >> 2;
+    return !( pattern & (pattern>>1) & (pattern>>2) & keep ) &&
+            !( inv & (inv>>1) & (inv>>2) & keep );
+}
+
+
+///
+/// forced_line
+///
+/// a row or column has a single possible completion once one of its
+/// digits reaches dim/2, since every blank must then be the other
+/// digit; a filled line is the trivial case
+///
+/// @param dir - the vector direction, either row or column
+/// @param idx - the row or column number
+/// @param pattern - where the completed line is stored
+///
+/// @return - true if the line has a single completion; otherwise, false
+///
+static bool KERNEL_NAME( forced_line )( Vector dir, int idx, size_t* pattern ){
+    int** count = dir == ROW ? row_count : col_count;
+    Digit fill;
+
+    if( count[ZERO][idx] == dim/2 )
+        fill = ONE;
+    else if( count[ONE][idx] == dim/2 )
+        fill = ZERO;
+    else
+        return false;
+
+    *pattern = KERNEL_NAME( fill_line )( dir, idx, &fill, 1 );
+    return true;
+}
+
+
+///
+/// duplicates_line
+///
+/// checks if a completed line pattern is a copy of another
+/// row or column that has only one possible completion
+///
+/// @param dir - the vector direction, either row or column
+/// @param idx - the row or column the pattern belongs to
+/// @param pattern - the completed line
+///
+/// @return - true if the pattern duplicates another line; otherwise, false
+///
+static bool KERNEL_NAME( duplicates_line )( Vector dir, int idx, size_t pattern ){
+    size_t other;
+    int j;
+    for( j=0; j<dim; j++ )
+        if( j != idx && KERNEL_NAME( forced_line )( dir, j, &other ) && other == pattern )
+            return true;
+    return false;
+}
+
+
+///
+/// chk_forced_line
+///
+/// uniqueness and adjacency reasoning on a partially filled line:
+///     - a line with a single possible completion fails if that
+///       completion has three adjacent digits or copies another
+///       line that is also completed or forced
+///     - a line with two blanks that still need one 0 and one 1 has
+///       two completions; any completion copying a forced line or
+///       breaking adjacency is ruled out, and the line fails when
+///       both are ruled out
+///
+/// @param dir - the vector direction, either row or column
+/// @param idx - the row or column number
+///
+/// @return - true if the line can still be completed uniquely; otherwise, false
+///
+static bool KERNEL_NAME( chk_forced_line )( Vector dir, int idx ){
+    static const Digit zero_one[] = { ZERO, ONE };
+    static const Digit one_zero[] = { ONE, ZERO };
+    int** count = dir == ROW ? row_count : col_count;
+    size_t pattern;
+
+    if( KERNEL_NAME( forced_line )( dir, idx, &pattern ) )
+        return KERNEL_NAME( no_triples )( pattern ) &&
+                !KERNEL_NAME( duplicates_line )( dir, idx, pattern );
+
+    if( dim - count[ZERO][idx] - count[ONE][idx] != 2 )
+        return true;
+
+    pattern = KERNEL_NAME( fill_line )( dir, idx, zero_one, 2 );
+    if( KERNEL_NAME( no_triples )( pattern ) && !KERNEL_NAME( duplicates_line )( dir, idx, pattern ) )
+        return true;
+
+    pattern = KERNEL_NAME( fill_line )( dir, idx, one_zero, 2 );
+    return KERNEL_NAME( no_triples )( pattern ) &&
+            !KERNEL_NAME( duplicates_line )( dir, idx, pattern );
+}
+
+
+///
+/// chk_unique_line
+///
+/// once a row or column is filled, checks that it differs from every
+/// other filled row or column; the hash of each filled line is kept in
+/// the hash collection, and set as the line is filled
+///
+/// @param dir - the vector direction, either row or column
+/// @param idx - the row or column number
+///
+/// @return - true if the line is unique or not yet filled; otherwise, false
+///
+static bool KERNEL_NAME( chk_unique_line )( Vector dir, int idx ){
+    static const Digit none = BLANK;
+    int** count = dir == ROW ? row_count : col_count;
+    int j;
+
+    // check if line is filled
+    if( count[ZERO][idx] + count[ONE][idx] != dim )
+        return true;
+
+    size_t cur_hash = KERNEL_NAME( fill_line )( dir, idx, &none, 1 );
+    set_HashInfo( hashinfo, dir, idx, cur_hash );
+
+    for( j=0; j<dim; j++ )
+        if( j != idx && count[ZERO][j] + count[ONE][j] == dim &&
+                cur_hash == get_HashInfo( hashinfo, dir, j ) )
+            return false;
+
+    return true;
+}
+
+
+///
+/// is_valid
+///
+/// when a digit is put on a cell, it would check the following:
+///     if the piece is not at the end of the row:
+///         - check adjacent digits (horizontal and vertical)
+///         - number of 0s == number of 1s in row and col
+///     for boards that fit the line memo:
+///         - the row and column can still be completed
+///     if the cell's row or column is filled:
+///         - check that it is unique
+///     for the cell's row and column:
+///         - check that a forced completion is not a duplicate
+///
+/// @param status - the cell spot that is being validated
+///
+/// @return true if the digit at cell is valid; otherwise, false
+///
+static bool KERNEL_NAME( is_valid )( int status ){
+    Digit d = (Digit)grid[status];
+    int r = status/dim, c = status%dim;
+
+    // check number of 0s == number of 1s in row and column
+    if( row_count[d][r] > dim/2 || col_count[d][c] > dim/2 ){
+        DEBUG_FALSE;
+        return false;
+    }
+
+    // check adjacency
+    if( !( KERNEL_NAME( chk_row_adj )( status, grid[status] ) && KERNEL_NAME( chk_col_adj )( status, grid[status] ) ) ){
+        DEBUG_FALSE;
+        return false;
+    }
+
+    // the row and column can still be completed
+    if( dim <= LINE_MEMO_MAX_DIM && !KERNEL_NAME( chk_line_memo )( status ) ){
+        DEBUG_FALSE;
+        return false;
+    }
+
+    // filled row or column
+    if( !KERNEL_NAME( chk_unique_line )( ROW, r ) || !KERNEL_NAME( chk_unique_line )( COL, c ) ){
+        DEBUG_FALSE;
+        return false;
+    }
+
+    // partially filled row and column can still be made unique
+    if( !KERNEL_NAME( chk_forced_line )( ROW, r ) || !KERNEL_NAME( chk_forced_line )( COL, c ) ){
+        DEBUG_FALSE;
+        return false;
+    }
+
+    DEBUG_TRUE;
+    return true;
+}
+
+
+///
+/// bt_solve
+///
+/// performs the actual backtracking method
+///
+/// @param depth the number of cells already visited; the cell to
+///                backtrack on is order[depth]
+///
+/// @return true if backtracker finds a solution; otherwise, false
+///
+static bool KERNEL_NAME( bt_solve )( int depth ){
+    // goal reached
+    if( IS_GOAL )
+        return true;
+
+    // give up or restart once a limit is hit
+    if( ++nodes >= next_check && out_of_budget( ) )
+        return false;
+
+    // remember the deepest partial board
+    if( depth > best_depth ){
+        best_depth = depth;
+        memcpy( best, grid, dim*dim * sizeof( char ) );
+    }
+
+    int status = order[depth];
+    int mark = trail_len;
+
+    // check if cell in board is already fixed
+    if( fixed[status] )
+        return KERNEL_NAME( bt_solve )( depth+1 );
+
+    // probe near the root, which was probed before the search; the
+    // cells it forces are undone on backtrack
+    if( depth > 0 && depth < limits.probe_depth && !probe( ) ){
+        undo_to( mark );
+        return false;
+    }
+
+    // the cell was forced by probing
+    if( grid[status] != BLANK ){
+        if( KERNEL_NAME( is_valid )( status ) && KERNEL_NAME( bt_solve )( depth+1 ) )
+            return true;
+        undo_to( mark );
+        return false;
+    }
+
+    // lay digits and validate, in a random order if seeded
+    Digit first = limits.seed && ( next_random( &rng ) & 1 ) ? ONE : ZERO;
+    int k;
+    for( k=0; k<2; k++ ){
+        Digit i = k ? !first : first;
+
+        // put digit in spot
+        KERNEL_NAME( put )( status, i );
+
+        DEBUG_BRD;
+
+        // advance a depth if valid
+        if( KERNEL_NAME( is_valid )( status ) && KERNEL_NAME( bt_solve )( depth+1 ) )
+            return true;
+
+        // unwind without trying the other digit
+        if( interrupted )
+            break;
+    }
+
+    KERNEL_NAME( put )( status, BLANK );
+    undo_to( mark );
+    DEBUG_BRD;
+    return false;
+}
+
+
+#undef dim
@@ -0,0 +1,306 @@
+///
+/// file:
+///     binairo_lanes.c
+///
+/// author:
+///     awallien
+///
+/// description:
+///     implementation of the bit-sliced solver; every cell holds two
+///     words, the lanes in which it is known to be ONE and those in
+///     which it is known to be ZERO, and a line's digit counts are
+///     kept as bit planes, one word per binary digit of the count
+///
+/// date:
+///     10/19/26
+///
+
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "binairo_board.h"
+#include "binairo_bt.h"
+#include "binairo_lanes.h"
+
+
+/// bit planes needed to count up to LANES_MAX_DIM digits in a line
+#define PLANES 5
+
+/// the lane of a single puzzle
+#define LANE( i ) ( (LaneMask)1 << ( i ) )
+
+
+/// a group of puzzles, one per lane
+typedef struct LaneGroupStruct {
+    LaneMask one[LANES_MAX_DIM*LANES_MAX_DIM];     /// lanes in which the cell holds ONE
+    LaneMask zero[LANES_MAX_DIM*LANES_MAX_DIM];    /// lanes in which the cell holds ZERO
+    LaneMask live;                                  /// lanes holding a puzzle
+    LaneMask bad;                                   /// lanes found to have no solution
+    int dim;                                        /// dimension of every puzzle
+} LaneGroup;
+
+
+///
+/// force
+///
+/// makes a cell hold a digit in the lanes given
+///
+/// @param digit - the lanes holding the digit, per cell
+/// @param cell - the cell
+/// @param lanes - the lanes in which the cell must hold it
+///
+/// @return - true if a lane did not hold it already; otherwise, false
+///
+static bool force( LaneMask* digit, int cell, LaneMask lanes ){
+    lanes &= ~digit[cell];
+    digit[cell] |= lanes;
+    return lanes != 0;
+}
+
+
+///
+/// propagate_line
+///
+/// applies the pair, sandwich and count rules for one digit to a
+/// line in every lane, and flags the lanes in which it is broken
+///
+/// @param g - the group
+/// @param digit - the lanes holding the digit, per cell
+/// @param other - the lanes holding the other digit, per cell
+/// @param start - the first cell of the line
+/// @param step - the distance between its cells
+///
+/// @return - true if a cell changed in some lane; otherwise, false
+///
+static bool propagate_line( LaneGroup* g, LaneMask* digit, LaneMask* other,
+                            int start, int step ){
+    int dim = g->dim, half = dim / 2;
+    LaneMask plane[PLANES] = { 0 };
+    LaneMask ok = g->live & ~g->bad;
+    LaneMask carry, more, same, t;
+    bool changed = false;
+    int i, k, a, b, c;
+
+    // pairs and sandwiches: two of a digit force the other on the third cell
+    for( i=0; i+2<dim; i++ ){
+        a = start + i*step;
+        b = a + step;
+        c = b + step;
+        g->bad |= digit[a] & digit[b] & digit[c];
+        changed |= force( other, c, digit[a] & digit[b] & ok );
+        changed |= force( other, a, digit[b] & digit[c] & ok );
+        changed |= force( other, b, digit[a] & digit[c] & ok );
+    }
+
+    // count the digit with a ripple-carry adder on the bit planes
+    for( i=0; i<dim; i++ ){
+        carry = digit[start + i*step];
+        for( k=0; k<PLANES && carry; k++ ){
+            t = plane[k] & carry;
+            plane[k] ^= carry;
+            carry = t;
+        }
+    }
+
+    // compare the count with half the line, from the top plane down
+    more = 0;
+    same = ~(LaneMask)0;
+    for( k=PLANES-1; k>=0; k-- ){
+        if( half >> k & 1 )
+            same &= plane[k];
+        else{
+            more |= same & plane[k];
+            same &= ~plane[k];
+        }
+    }
+    g->bad |= more;
+
+    // a line holding half of the digit takes the other everywhere else
+    same &= ~g->bad & g->live;
+    if( same )
+        for( i=0; i<dim; i++ )
+            changed |= force( other, start + i*step, same & ~digit[start + i*step] );
+
+    return changed;
+}
+
+
+///
+/// check_alike
+///
+/// flags the filled lanes in which two rows or two columns are alike
+///
+/// @param g - the group
+/// @param filled - the lanes with every cell filled
+///
+static void check_alike( LaneGroup* g, LaneMask filled ){
+    int dim = g->dim;
+    int i, j, p;
+    LaneMask rows, cols;
+
+    for( i=0; i<dim; i++ )
+        for( j=i+1; j<dim; j++ ){
+            rows = cols = filled;
+            for( p=0; p<dim && ( rows | cols ); p++ ){
+                rows &= ~( g->one[i*dim + p] ^ g->one[j*dim + p] );
+                cols &= ~( g->one[p*dim + i] ^ g->one[p*dim + j] );
+            }
+            g->bad |= rows | cols;
+        }
+}
+
+
+///
+/// propagate_lanes
+///
+/// applies the rules to every line of every lane until no cell
+/// changes, then checks the filled lanes for alike lines
+///
+/// @param g - the group
+///
+/// @return - the lanes with every cell filled and no rule broken
+///
+static LaneMask propagate_lanes( LaneGroup* g ){
+    int dim = g->dim;
+    int line, cell;
+    bool changed = true;
+    LaneMask filled;
+
+    while( changed ){
+        changed = false;
+        for( line=0; line<dim; line++ ){
+            changed |= propagate_line( g, g->one, g->zero, line*dim, 1 );
+            changed |= propagate_line( g, g->zero, g->one, line*dim, 1 );
+            changed |= propagate_line( g, g->one, g->zero, line, dim );
+            changed |= propagate_line( g, g->zero, g->one, line, dim );
+        }
+        for( cell=0; cell<dim*dim; cell++ )
+            g->bad |= g->one[cell] & g->zero[cell];
+        if( ( g->live & ~g->bad ) == 0 )
+            break;
+    }
+
+    filled = g->live & ~g->bad;
+    for( cell=0; cell<dim*dim && filled; cell++ )
+        filled &= g->one[cell] | g->zero[cell];
+    check_alike( g, filled );
+
+    return filled & ~g->bad;
+}
+
+
+///
+/// lane_digit
+///
+/// @param g - the group
+/// @param lane - the lane
+/// @param cell - the cell
+///
+/// @return - the digit the cell holds in the lane, or BLANK
+///
+static Digit lane_digit( const LaneGroup* g, int lane, int cell ){
+    if( g->one[cell] & LANE( lane ) )
+        return ONE;
+    if( g->zero[cell] & LANE( lane ) )
+        return ZERO;
+    return BLANK;
+}
+
+
+///
+/// solve_lane
+///
+/// hands a lane to the ordinary backtracker, with the cells deduced
+/// in lockstep as givens, and copies its board back
+///
+/// @param board - the lane's board
+/// @param g - the group
+/// @param lane - the lane
+/// @param options - the limits on the search; NULL for none
+///
+/// @return - the outcome of the search
+///
+static SolveResult solve_lane( BinairoBoard board, const LaneGroup* g, int lane,
+                               const SolveOptions* options ){
+    BinairoBoard puzzle = copy_BinairoBoard( board );
+    int dim = g->dim;
+    int cell;
+    Digit d;
+
+    for( cell=0; cell<dim*dim; cell++ )
+        if( !is_marked_BinairoBoard( board, cell ) &&
+            ( d = lane_digit( g, lane, cell ) ) != BLANK )
+            give_BinairoBoard( puzzle, cell, d );
+
+    bt_initialize( puzzle, false, 0 );
+    SolveResult res = solve_bounded( options );
+
+    for( cell=0; cell<dim*dim; cell++ )
+        if( !is_marked_BinairoBoard( board, cell ) ){
+            put_BinairoBoard( board, cell, get_BinairoBoard( puzzle, cell ) );
+            if( lane_digit( g, lane, cell ) != BLANK || is_proven_BinairoBoard( puzzle, cell ) )
+                prove_BinairoBoard( board, cell );
+        }
+
+    destroy_BinairoBoard( puzzle );
+    return res;
+}
+
+
+/// solve boards in lanes
+int solve_lanes( BinairoBoard* boards, int count, const SolveOptions* options,
+                 SolveResult* results ){
+    LaneGroup g;
+    LaneMask filled;
+    int first, lane, lanes, cell;
+    int settled = 0;
+    Digit d;
+
+    assert( count == 0 || dim_BinairoBoard( boards[0] ) <= LANES_MAX_DIM );
+
+    for( first=0; first<count; first+=LANES ){
+        lanes = count - first < LANES ? count - first : LANES;
+
+        // load the givens of each board into its lane
+        memset( &g, 0, sizeof( g ) );
+        g.dim = dim_BinairoBoard( boards[first] );
+        for( lane=0; lane<lanes; lane++ ){
+            assert( dim_BinairoBoard( boards[first+lane] ) == g.dim );
+            g.live |= LANE( lane );
+            for( cell=0; cell<g.dim*g.dim; cell++ ){
+                d = get_BinairoBoard( boards[first+lane], cell );
+                if( d == ONE )
+                    g.one[cell] |= LANE( lane );
+                else if( d == ZERO )
+                    g.zero[cell] |= LANE( lane );
+            }
+        }
+
+        filled = propagate_lanes( &g );
+
+        // settle each lane, or leave it to the backtracker
+        for( lane=0; lane<lanes; lane++ ){
+            BinairoBoard board = boards[first+lane];
+            if( g.bad & LANE( lane ) ){
+                results[first+lane] = NO_SOLUTION;
+                settled++;
+            }
+            else if( filled & LANE( lane ) ){
+                for( cell=0; cell<g.dim*g.dim; cell++ )
+                    if( !is_marked_BinairoBoard( board, cell ) ){
+                        put_BinairoBoard( board, cell, lane_digit( &g, lane, cell ) );
+                        prove_BinairoBoard( board, cell );
+                    }
+                results[first+lane] = SOLVED;
+                settled++;
+            }
+            else
+                results[first+lane] = solve_lane( board, &g, lane, options );
+        }
+    }
+
+    return settled;
+}
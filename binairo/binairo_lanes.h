@@ -0,0 +1,61 @@
+///
+/// file:
+///     binairo_lanes.h
+///
+/// author:
+///     awallien
+///
+/// description:
+///     solves many small boards of one dimension at once, bit-sliced:
+///     each bit of a machine word is one puzzle's lane, so the rules
+///     are applied to every lane with the same few word operations,
+///     without a branch per puzzle
+///
+/// date:
+///     10/19/26
+///
+
+
+#ifndef __BINAIRO_LANES_H_
+#define __BINAIRO_LANES_H_
+
+#include <stdint.h>
+#include "binairo_board.h"
+#include "binairo_bt.h"
+
+
+/// one bit per puzzle
+typedef uint64_t LaneMask;
+
+/// number of puzzles solved side by side
+#define LANES 64
+
+/// largest dimension solved in lanes
+#define LANES_MAX_DIM 16
+
+
+///
+/// solve_lanes
+///
+/// solves the boards LANES at a time; in each group, the pair,
+/// sandwich and line count rules are propagated on every lane in
+/// lockstep until none changes, and each filled lane is checked for
+/// alike rows and columns; a lane left with blank cells is handed,
+/// with its deductions as givens, to the ordinary backtracker
+///
+/// each board receives its solution, or its deepest partial board if
+/// the backtracker gave up
+///
+/// @param boards - the boards, all of the same even dimension, at most
+///                 LANES_MAX_DIM
+/// @param count - the number of boards
+/// @param options - the limits for each backtracker; NULL for none
+/// @param results - where the outcome of each board is stored
+///
+/// @return - the number of boards settled without the backtracker
+///
+int solve_lanes( BinairoBoard* boards, int count, const SolveOptions* options,
+                 SolveResult* results );
+
+
+#endif //__BINAIRO_LANES_H_
@@ -0,0 +1,629 @@
+///
+/// file:
+///     binairo_large.c
+///
+/// author:
+///     awallien
+///
+/// description:
+///     implementation of the large-board solver; cell i of a line is bit
+///     i%64 of word i/64 of its bitsets, lines are numbered with the rows
+///     first and the columns after them, and every cell the search
+///     assigns goes on one trail, so undoing a branch pops the trail back
+///     to its length when the branch was taken
+///
+/// date:
+///     10/19/26
+///
+
+
+#define _DEFAULT_SOURCE
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "binairo_board.h"
+#include "binairo_bt.h"
+#include "binairo_large.h"
+#include "binairo_memo.h"
+
+
+/// a branch of the search
+typedef struct DecisionStruct {
+    int cell;                       /// the cell branched on
+    int digit;                      /// the digit it holds on this branch
+    int mark;                       /// length of the trail before the branch
+    bool flipped;                   /// the branch is the cell's second digit
+} Decision;
+
+/// the solver's state
+typedef struct LargeStruct {
+    int dim;                        /// dimension of the board
+    int words;                      /// words of a line's bitsets
+    int kwords;                     /// words of a mask of ONE counts, 0 to dim/2
+    char* grid;                     /// one Digit per cell, row-major
+    uint64_t* filled;               /// bits of each line's filled cells
+    uint64_t* ones;                 /// bits of each line's cells holding ONE
+    int* count[2];                  /// number of each digit in each line
+    uint64_t* hash;                 /// hash of each full line's digits
+
+    int* trail;                     /// cells assigned, in order
+    int trail_len;                  /// number of cells assigned
+    Decision* decisions;            /// the open branches, oldest first
+    int depth;                      /// number of open branches
+
+    int* queue;                     /// lines changed since they were last worked
+    int head;                       /// first line of the circular queue
+    int queue_len;                  /// number of lines in the queue
+    bool* queued;                   /// is each line in the queue, or being worked
+
+    uint64_t* forward;              /// states reached after each cell of a line
+    uint64_t* backward;             /// states that can still end the line
+    uint64_t* shifted;              /// the backward states shifted down a count
+    uint64_t* can[2];               /// cells of a line that can hold each digit
+
+    char* best;                     /// deepest partial board reached
+    int best_len;                   /// number of cells it had assigned
+    unsigned long long rng;         /// state of the random number generator
+} Large;
+
+
+///
+/// line_cell
+///
+/// @param s - the solver
+/// @param line - a row, or dim plus a column
+/// @param pos - the position along the line
+///
+/// @return - the cell at that position
+///
+static int line_cell( const Large* s, int line, int pos ){
+    return line < s->dim ? line * s->dim + pos : pos * s->dim + ( line - s->dim );
+}
+
+
+///
+/// create_large
+///
+/// @param dim - the dimension of the board
+/// @param seed - the seed of the search's random choices, or 0 for none
+///
+/// @return - an empty solver for boards of that dimension
+///
+static Large* create_large( int dim, unsigned long seed ){
+    Large* s = calloc( 1, sizeof( Large ) );
+    int lines = 2*dim;
+
+    assert( s );
+    s->dim = dim;
+    s->words = ( dim + 63 ) / 64;
+    s->kwords = dim/2 / 64 + 1;
+    s->grid = malloc( dim*dim * sizeof( char ) );
+    s->best = malloc( dim*dim * sizeof( char ) );
+    s->filled = calloc( lines * s->words, sizeof( uint64_t ) );
+    s->ones = calloc( lines * s->words, sizeof( uint64_t ) );
+    s->count[0] = calloc( lines, sizeof( int ) );
+    s->count[1] = calloc( lines, sizeof( int ) );
+    s->hash = calloc( lines, sizeof( uint64_t ) );
+    s->trail = malloc( dim*dim * sizeof( int ) );
+    s->decisions = malloc( dim*dim * sizeof( Decision ) );
+    s->queue = malloc( lines * sizeof( int ) );
+    s->queued = calloc( lines, sizeof( bool ) );
+    s->forward = malloc( ( dim+1 ) * TAILS * s->kwords * sizeof( uint64_t ) );
+    s->backward = malloc( TAILS * s->kwords * sizeof( uint64_t ) );
+    s->shifted = malloc( TAILS * s->kwords * sizeof( uint64_t ) );
+    s->can[0] = malloc( s->words * sizeof( uint64_t ) );
+    s->can[1] = malloc( s->words * sizeof( uint64_t ) );
+    assert( s->grid && s->best && s->filled && s->ones && s->count[0] && s->count[1] &&
+            s->hash && s->trail && s->decisions && s->queue && s->queued && s->forward &&
+            s->backward && s->shifted && s->can[0] && s->can[1] );
+
+    memset( s->grid, BLANK, dim*dim * sizeof( char ) );
+    s->best_len = -1;
+    s->rng = seed ? seed * 0x9E3779B97F4A7C15ULL + 1 : 0;
+    return s;
+}
+
+
+///
+/// destroy_large
+///
+/// @param s - the solver to free
+///
+static void destroy_large( Large* s ){
+    free( s->grid );
+    free( s->best );
+    free( s->filled );
+    free( s->ones );
+    free( s->count[0] );
+    free( s->count[1] );
+    free( s->hash );
+    free( s->trail );
+    free( s->decisions );
+    free( s->queue );
+    free( s->queued );
+    free( s->forward );
+    free( s->backward );
+    free( s->shifted );
+    free( s->can[0] );
+    free( s->can[1] );
+    free( s );
+}
+
+
+///
+/// enqueue
+///
+/// @param s - the solver
+/// @param line - a line whose cells changed
+///
+static void enqueue( Large* s, int line ){
+    if( s->queued[line] )
+        return;
+    s->queued[line] = true;
+    s->queue[( s->head + s->queue_len++ ) % ( 2*s->dim )] = line;
+}
+
+
+///
+/// flip_bits
+///
+/// sets or clears a cell's bits in one of its lines
+///
+/// @param s - the solver
+/// @param line - the line
+/// @param pos - the cell's position along it
+/// @param digit - the cell's digit
+/// @param on - set the bits, rather than clear them
+///
+static void flip_bits( Large* s, int line, int pos, int digit, bool on ){
+    uint64_t bit = (uint64_t)1 << ( pos % 64 );
+    int word = line * s->words + pos / 64;
+
+    if( on ){
+        s->filled[word] |= bit;
+        if( digit )
+            s->ones[word] |= bit;
+    }
+    else{
+        s->filled[word] &= ~bit;
+        s->ones[word] &= ~bit;
+    }
+    s->count[digit][line] += on ? 1 : -1;
+}
+
+
+///
+/// assign
+///
+/// puts a digit on a blank cell, on the trail, and queues both of
+/// its lines
+///
+/// @param s - the solver
+/// @param cell - the cell
+/// @param digit - the digit
+///
+static void assign( Large* s, int cell, int digit ){
+    int row = cell / s->dim, col = cell % s->dim;
+
+    s->grid[cell] = (char)digit;
+    s->trail[s->trail_len++] = cell;
+    flip_bits( s, row, col, digit, true );
+    flip_bits( s, s->dim + col, row, digit, true );
+    enqueue( s, row );
+    enqueue( s, s->dim + col );
+}
+
+
+///
+/// undo
+///
+/// blanks the cells assigned since the trail had a length
+///
+/// @param s - the solver
+/// @param mark - the length to pop the trail back to
+///
+static void undo( Large* s, int mark ){
+    while( s->trail_len > mark ){
+        int cell = s->trail[--s->trail_len];
+        int row = cell / s->dim, col = cell % s->dim;
+        flip_bits( s, row, col, s->grid[cell], false );
+        flip_bits( s, s->dim + col, row, s->grid[cell], false );
+        s->grid[cell] = BLANK;
+    }
+}
+
+
+///
+/// is_full
+///
+/// @param s - the solver
+/// @param line - the line
+///
+/// @return - true if every cell of the line is filled; otherwise, false
+///
+static bool is_full( const Large* s, int line ){
+    return s->count[0][line] + s->count[1][line] == s->dim;
+}
+
+
+///
+/// chk_unique
+///
+/// hashes a full line's words, and compares them with those of every
+/// other full line of its direction with the same hash
+///
+/// @param s - the solver
+/// @param line - the full line
+///
+/// @return - false if another full line is alike; otherwise, true
+///
+static bool chk_unique( Large* s, int line ){
+    const uint64_t* bits = s->ones + line * s->words;
+    int first = line < s->dim ? 0 : s->dim;
+    uint64_t hash = 0x84222325CBF29CE4ULL;
+    int other, w;
+
+    for( w=0; w<s->words; w++ ){
+        hash = ( hash ^ bits[w] ) * 0x9E3779B97F4A7C15ULL;
+        hash ^= hash >> 29;
+    }
+    s->hash[line] = hash;
+
+    for( other=first; other<first+s->dim; other++ )
+        if( other != line && s->hash[other] == hash && is_full( s, other ) &&
+                memcmp( s->ones + other * s->words, bits, s->words * sizeof( uint64_t ) ) == 0 )
+            return false;
+    return true;
+}
+
+
+///
+/// work_line
+///
+/// finds the digits each cell of a line can hold in some completion,
+/// as in the line memo, with the states after each cell kept as one
+/// mask of several words per tail, bit k set when k ONEs can precede
+/// it; a ZERO extends the ONE tails and ZERO1, and a ONE, which shifts
+/// the masks up a count, extends the ZERO tails and ONE1
+///
+/// @param s - the solver, whose can masks receive the cells of the
+///            line that can hold each digit
+/// @param line - the line
+///
+/// @return - true if the line can be completed; otherwise, false
+///
+static bool work_line( Large* s, int line ){
+    const uint64_t* filled = s->filled + line * s->words;
+    const uint64_t* ones = s->ones + line * s->words;
+    int dim = s->dim, half = dim/2, kw = s->kwords, stride = TAILS * kw;
+    uint64_t cap = half % 64 == 63 ? ~(uint64_t)0 : ( (uint64_t)1 << ( half % 64 + 1 ) ) - 1;
+    uint64_t* back = s->backward;
+    uint64_t* up = s->shifted;
+    int i, w, tail;
+
+    // at most dim/2 ONEs, and at most dim/2 ZEROs, after each cell
+    memset( s->forward, 0, stride * sizeof( uint64_t ) );
+    s->forward[START * kw] = 1;
+    for( i=0; i<dim; i++ ){
+        const uint64_t* from = s->forward + i * stride;
+        uint64_t* to = s->forward + ( i+1 ) * stride;
+        bool may[2] = { true, true };
+        int low = i+1 - half;
+        uint64_t any = 0, carry[2] = { 0, 0 };
+
+        if( filled[i / 64] >> ( i % 64 ) & 1 )
+            may[!( ones[i / 64] >> ( i % 64 ) & 1 )] = false;
+
+        for( w=0; w<kw; w++ ){
+            uint64_t zero = may[0] ? from[START*kw+w] | from[ONE1*kw+w] | from[ONE2*kw+w] : 0;
+            uint64_t one = may[1] ? from[START*kw+w] | from[ZERO1*kw+w] | from[ZERO2*kw+w] : 0;
+            uint64_t twice = may[1] ? from[ONE1*kw+w] : 0;
+            uint64_t low_mask = low <= w * 64 ? ~(uint64_t)0 : low >= ( w+1 ) * 64 ? 0 :
+                                ~( ( (uint64_t)1 << ( low - w * 64 ) ) - 1 );
+            uint64_t cap_mask = w == kw-1 ? cap : ~(uint64_t)0;
+
+            to[START*kw+w] = 0;
+            to[ZERO1*kw+w] = zero & low_mask;
+            to[ZERO2*kw+w] = ( may[0] ? from[ZERO1*kw+w] : 0 ) & low_mask;
+            to[ONE1*kw+w] = ( one << 1 | carry[0] ) & low_mask & cap_mask;
+            to[ONE2*kw+w] = ( twice << 1 | carry[1] ) & low_mask & cap_mask;
+            carry[0] = one >> 63;
+            carry[1] = twice >> 63;
+            for( tail=ZERO1; tail<TAILS; tail++ )
+                any |= to[tail*kw+w];
+        }
+        if( !any )
+            return false;
+    }
+
+    // back from the end, where exactly dim/2 ONEs came before; the
+    // masks of the tails after a ONE are kept shifted down a count
+    memset( back, 0, TAILS * kw * sizeof( uint64_t ) );
+    if( dim % 2 == 0 )
+        for( tail=0; tail<TAILS; tail++ )
+            back[tail * kw + half / 64] = (uint64_t)1 << ( half % 64 );
+    memset( s->can[0], 0, s->words * sizeof( uint64_t ) );
+    memset( s->can[1], 0, s->words * sizeof( uint64_t ) );
+    for( i=dim-1; i>=0; i-- ){
+        const uint64_t* before = s->forward + i * stride;
+        bool may[2] = { true, true };
+        uint64_t through[2] = { 0, 0 };
+
+        if( filled[i / 64] >> ( i % 64 ) & 1 )
+            may[!( ones[i / 64] >> ( i % 64 ) & 1 )] = false;
+
+        for( w=0; w<kw; w++ )
+            for( tail=ONE1; tail<=ONE2; tail++ )
+                up[tail*kw+w] = back[tail*kw+w] >> 1 | ( w+1 < kw ? back[tail*kw+w+1] << 63 : 0 );
+
+        for( w=0; w<kw; w++ ){
+            uint64_t zero1 = may[0] ? back[ZERO1*kw+w] : 0;
+            uint64_t zero2 = may[0] ? back[ZERO2*kw+w] : 0;
+            uint64_t one1 = may[1] ? up[ONE1*kw+w] : 0;
+            uint64_t one2 = may[1] ? up[ONE2*kw+w] : 0;
+
+            through[0] |= ( before[START*kw+w] | before[ONE1*kw+w] | before[ONE2*kw+w] ) & zero1;
+            through[0] |= before[ZERO1*kw+w] & zero2;
+            through[1] |= ( before[START*kw+w] | before[ZERO1*kw+w] | before[ZERO2*kw+w] ) & one1;
+            through[1] |= before[ONE1*kw+w] & one2;
+
+            back[START*kw+w] = zero1 | one1;
+            back[ZERO1*kw+w] = zero2 | one1;
+            back[ZERO2*kw+w] = one1;
+            back[ONE1*kw+w] = zero1 | one2;
+            back[ONE2*kw+w] = zero1;
+        }
+        if( through[0] )
+            s->can[0][i / 64] |= (uint64_t)1 << ( i % 64 );
+        if( through[1] )
+            s->can[1][i / 64] |= (uint64_t)1 << ( i % 64 );
+    }
+
+    return back[START * kw] & 1;
+}
+
+
+///
+/// two_blanks
+///
+/// a line with two blanks, each free to hold either digit, completes
+/// one of two ways; if a full line of its direction matches it on its
+/// filled cells, that completion would duplicate it, so the other one
+/// is assigned
+///
+/// @param s - the solver
+/// @param line - the line
+///
+/// @return - false if the completion duplicates another line; otherwise, true
+///
+static bool two_blanks( Large* s, int line ){
+    const uint64_t* filled = s->filled + line * s->words;
+    const uint64_t* ones = s->ones + line * s->words;
+    int first = line < s->dim ? 0 : s->dim;
+    int other, w, pos;
+
+    for( other=first; other<first+s->dim; other++ ){
+        const uint64_t* theirs = s->ones + other * s->words;
+        if( other == line || !is_full( s, other ) )
+            continue;
+        for( w=0; w<s->words && !( ( theirs[w] ^ ones[w] ) & filled[w] ); w++ )
+            ;
+        if( w < s->words )
+            continue;
+
+        for( pos=0; pos<s->dim; pos++ )
+            if( !( filled[pos / 64] >> ( pos % 64 ) & 1 ) )
+                assign( s, line_cell( s, line, pos ), !( theirs[pos / 64] >> ( pos % 64 ) & 1 ) );
+        return chk_unique( s, line );
+    }
+    return true;
+}
+
+
+///
+/// work
+///
+/// assigns the cells a changed line forces, which queues the lines
+/// crossing them
+///
+/// @param s - the solver
+/// @param line - the line
+///
+/// @return - false if the line can no longer be completed; otherwise, true
+///
+static bool work( Large* s, int line ){
+    int w, b;
+
+    if( !work_line( s, line ) )
+        return false;
+
+    for( w=0; w<s->words; w++ ){
+        uint64_t open = ~s->filled[line * s->words + w];
+        uint64_t forced[2] = { s->can[0][w] & ~s->can[1][w] & open,
+                               s->can[1][w] & ~s->can[0][w] & open };
+        for( b=0; b<64; b++ )
+            if( ( forced[0] | forced[1] ) >> b & 1 )
+                assign( s, line_cell( s, line, w * 64 + b ), forced[1] >> b & 1 );
+    }
+
+    if( is_full( s, line ) )
+        return chk_unique( s, line );
+    if( s->count[0][line] + s->count[1][line] == s->dim - 2 )
+        return two_blanks( s, line );
+    return true;
+}
+
+
+///
+/// propagate
+///
+/// works the queued lines until none is left
+///
+/// @param s - the solver
+///
+/// @return - false if some line can no longer be completed, with the
+///           queue emptied; otherwise, true
+///
+static bool propagate( Large* s ){
+    while( s->queue_len > 0 ){
+        int line = s->queue[s->head];
+        bool ok = work( s, line );
+
+        s->head = ( s->head + 1 ) % ( 2*s->dim );
+        s->queue_len--;
+        s->queued[line] = false;
+        if( !ok ){
+            while( s->queue_len > 0 ){
+                s->queued[s->queue[s->head]] = false;
+                s->head = ( s->head + 1 ) % ( 2*s->dim );
+                s->queue_len--;
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+
+///
+/// pick
+///
+/// chooses a blank cell of the line with the fewest blanks, the first
+/// one or, with a seed, one at random, and the digit its row and column
+/// together have fewer of, which keeps both lines balanced as they fill
+///
+/// @param s - the solver
+/// @param digit - where the digit is stored
+///
+/// @return - the cell, or -1 if the board is full
+///
+static int pick( Large* s, int* digit ){
+    int line, chosen = -1, fewest = s->dim + 1, pos, skip = 0;
+    int cell, row, col, zeros, ones;
+
+    for( line=0; line<2*s->dim; line++ ){
+        int blanks = s->dim - s->count[0][line] - s->count[1][line];
+        if( blanks > 0 && blanks < fewest ){
+            fewest = blanks;
+            chosen = line;
+        }
+    }
+    if( chosen < 0 )
+        return -1;
+
+    if( s->rng )
+        skip = (int)( next_random( &s->rng ) % fewest );
+    for( pos=0; pos<s->dim; pos++ )
+        if( !( s->filled[chosen * s->words + pos / 64] >> ( pos % 64 ) & 1 ) && skip-- == 0 )
+            break;
+
+    // ties go to ZERO, or with a seed, to either digit
+    cell = line_cell( s, chosen, pos );
+    row = cell / s->dim;
+    col = s->dim + cell % s->dim;
+    zeros = s->count[0][row] + s->count[0][col];
+    ones = s->count[1][row] + s->count[1][col];
+    *digit = ones != zeros ? ones < zeros : s->rng ? (int)( next_random( &s->rng ) & 1 ) : 0;
+    return cell;
+}
+
+
+/// solve a large board
+SolveResult solve_large( BinairoBoard board, const SolveOptions* options ){
+    SolveOptions none = { .cancel = NULL };
+    int dim = dim_BinairoBoard( board );
+    Large* s;
+    SolveResult res;
+    unsigned long nodes = 0, conflicts = 0, run = 1;
+    unsigned long unit, restart_at;
+    struct timespec stop;
+    int cell, digit, line, root;
+    bool ok;
+
+    if( options == NULL )
+        options = &none;
+    unit = options->restart_unit ? options->restart_unit : LARGE_RESTART_UNIT;
+    restart_at = luby( run ) * unit;
+    deadline_from( options->deadline, &stop );
+
+    // the filled cells, then every line once, before any branch
+    s = create_large( dim, options->seed );
+    for( cell=0; cell<dim*dim; cell++ )
+        if( get_BinairoBoard( board, cell ) != BLANK )
+            assign( s, cell, get_BinairoBoard( board, cell ) );
+    for( line=0; line<2*dim; line++ )
+        enqueue( s, line );
+    ok = propagate( s );
+    root = s->trail_len;
+
+    for( ;; ){
+        if( !ok ){
+            if( s->trail_len > s->best_len ){
+                memcpy( s->best, s->grid, dim*dim * sizeof( char ) );
+                s->best_len = s->trail_len;
+            }
+
+            // restart on the Luby sequence, with the branches chosen at
+            // random from the first restart on
+            if( ++conflicts >= restart_at && s->depth > 0 ){
+                undo( s, root );
+                s->depth = 0;
+                restart_at = conflicts + luby( ++run ) * unit;
+                if( !s->rng )
+                    s->rng = run * 0x9E3779B97F4A7C15ULL + 1;
+                ok = true;
+                continue;
+            }
+
+            // back to the latest branch whose other digit is untried
+            while( s->depth > 0 && s->decisions[s->depth-1].flipped )
+                s->depth--;
+            if( s->depth == 0 ){
+                res = NO_SOLUTION;
+                break;
+            }
+            Decision* last = &s->decisions[s->depth-1];
+            undo( s, last->mark );
+            last->flipped = true;
+            last->digit = !last->digit;
+            assign( s, last->cell, last->digit );
+        }
+        else{
+            cell = pick( s, &digit );
+            if( cell < 0 ){
+                res = SOLVED;
+                break;
+            }
+            s->decisions[s->depth++] = (Decision){ cell, digit, s->trail_len, false };
+            assign( s, cell, digit );
+        }
+
+        nodes++;
+        if( ( options->max_nodes && nodes > options->max_nodes ) ||
+                ( nodes % CHECK_INTERVAL == 0 && out_of_time( options, &stop ) ) ){
+            res = GAVE_UP;
+            break;
+        }
+        ok = propagate( s );
+    }
+
+    // the solution, or the deepest partial board, onto the board
+    if( res == GAVE_UP && s->best_len > s->trail_len )
+        memcpy( s->grid, s->best, dim*dim * sizeof( char ) );
+    if( res != NO_SOLUTION ){
+        for( cell=0; cell<dim*dim; cell++ )
+            if( s->grid[cell] != BLANK && !is_marked_BinairoBoard( board, cell ) )
+                put_BinairoBoard( board, cell, s->grid[cell] );
+        for( cell=0; cell<root; cell++ )
+            if( !is_marked_BinairoBoard( board, s->trail[cell] ) )
+                prove_BinairoBoard( board, s->trail[cell] );
+    }
+
+    destroy_large( s );
+    return res;
+}
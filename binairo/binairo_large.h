@@ -0,0 +1,62 @@
+///
+/// file:
+///     binairo_large.h
+///
+/// author:
+///     awallien
+///
+/// description:
+///     a solver for boards too large for the backtracker's kernels, from
+///     64x64 up to 256x256: each line is a bitset of several words, a
+///     line's completions are worked out on every change before the
+///     search branches again, full lines are hashed to catch duplicates,
+///     and the search keeps its own stack of decisions instead of
+///     recursing once per cell
+///
+/// date:
+///     10/19/26
+///
+
+
+#ifndef __BINAIRO_LARGE_H_
+#define __BINAIRO_LARGE_H_
+
+#include "binairo_board.h"
+#include "binairo_bt.h"
+
+
+/// smallest dimension solved by this module rather than the backtracker,
+/// whose lines are packed into a single word
+#define LARGE_MIN_DIM 64
+
+/// largest dimension the module is tuned and tested for; larger boards
+/// are solved, only more slowly
+#define LARGE_MAX_DIM 256
+
+/// conflicts per unit of the Luby restart sequence, unless the options
+/// give a restart unit
+#define LARGE_RESTART_UNIT 100
+
+
+
+///
+/// solve_large
+///
+/// solves a board by propagating the rules of each changed line to a
+/// fixpoint, and branching on a blank cell of the line with the fewest
+/// blanks left only once nothing more follows; the seed of the options
+/// randomizes the branches, and the node limit bounds their number
+///
+/// after giving up, the board holds the deepest partial board reached,
+/// and the cells that follow from the givens alone are flagged as
+/// proven (see is_proven_BinairoBoard)
+///
+/// @param board - the binairo board
+/// @param options - the limits on the search; NULL for none
+///
+/// @return - SOLVED, NO_SOLUTION, or GAVE_UP if a limit was hit first
+///
+SolveResult solve_large( BinairoBoard board, const SolveOptions* options );
+
+
+#endif //__BINAIRO_LARGE_H_
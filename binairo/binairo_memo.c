@@ -0,0 +1,254 @@
+///
+/// file:
+///     binairo_memo.c
+///
+/// author:
+///     awallien
+///
+/// description:
+///     implementation of the line cache: a table per thread of small
+///     buckets, each kept in order of use, and filled on a miss by a
+///     pass forward and a pass backward over the line's states (ONEs
+///     so far, and the last digit and how many times it repeats); a
+///     thread's table is freed, and its counters added to shared
+///     totals, when the thread exits
+///
+/// date:
+///     10/19/26
+///
+
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "binairo_memo.h"
+
+
+/// an entry of the cache; an unused entry holds ONEs outside its filled cells
+typedef struct MemoEntryStruct {
+    uint64_t filled;                /// the key's filled cells
+    uint64_t ones;                  /// the key's cells holding ONE
+    LineFacts facts;                /// the cells forced in every completion
+} MemoEntry;
+
+/// a thread's cache, the dimension it holds, and its counters
+typedef struct LineMemoStruct {
+    MemoEntry table[LINE_MEMO_SIZE];
+    int dim;
+    LineMemoStats counters;
+} LineMemo;
+
+/// the calling thread's cache, made on its first lookup and freed
+/// through the key when the thread exits
+static __thread LineMemo* memo = NULL;
+static pthread_key_t memo_key;
+static pthread_once_t memo_once = PTHREAD_ONCE_INIT;
+
+/// the counters of every thread that has exited, added in as each exits
+static atomic_ullong exited_hits;
+static atomic_ullong exited_misses;
+static atomic_ullong exited_evictions;
+
+
+///
+/// free_LineMemo
+///
+/// adds an exiting thread's counters into the shared totals and frees
+/// its cache
+///
+/// @param arg - the thread's cache
+///
+static void free_LineMemo( void* arg ){
+    LineMemo* done = arg;
+
+    atomic_fetch_add_explicit( &exited_hits, done->counters.hits, memory_order_relaxed );
+    atomic_fetch_add_explicit( &exited_misses, done->counters.misses, memory_order_relaxed );
+    atomic_fetch_add_explicit( &exited_evictions, done->counters.evictions, memory_order_relaxed );
+    free( done );
+}
+
+
+///
+/// make_memo_key
+///
+/// creates the key whose destructor frees each thread's cache
+///
+static void make_memo_key( void ){
+    pthread_key_create( &memo_key, free_LineMemo );
+}
+
+
+///
+/// next_tail
+///
+/// @param tail - the tail of a line
+/// @param digit - the digit after it, 0 or 1
+///
+/// @return - the tail once the digit follows, or -1 if that makes three alike
+///
+static int next_tail( int tail, int digit ){
+    if( tail == START )
+        return digit ? ONE1 : ZERO1;
+    if( ( tail == ONE1 || tail == ONE2 ) != digit )
+        return digit ? ONE1 : ZERO1;
+    if( tail == ZERO2 || tail == ONE2 )
+        return -1;
+    return digit ? ONE2 : ZERO2;
+}
+
+
+///
+/// work_out
+///
+/// finds the digits each cell of a line can hold in some completion,
+/// with the states after each cell kept as one mask per tail, bit k set
+/// when k ONEs can precede it: a pass forward gives the states the
+/// filled cells let the line reach, and a pass backward the states
+/// from which it can still end with as many 0s as 1s
+///
+/// @param dim - the line length
+/// @param filled - the bits of the filled cells, first cell highest
+/// @param ones - the bits of the cells holding ONE
+/// @param facts - where the forced cells are stored
+///
+/// @return - true if the line can be completed; otherwise, false
+///
+static bool work_out( int dim, uint64_t filled, uint64_t ones, LineFacts* facts ){
+    uint64_t forward[LINE_MEMO_MAX_DIM+1][TAILS];
+    uint64_t backward[TAILS], earlier[TAILS];
+    uint64_t can[2] = { 0, 0 };
+    int half = dim/2;
+    uint64_t counts = ( (uint64_t)1 << ( half+1 ) ) - 1;
+    int i, tail, digit;
+
+    // at most dim/2 ONEs, and at most dim/2 ZEROs, after each cell
+    for( tail=0; tail<TAILS; tail++ )
+        forward[0][tail] = tail == START;
+    for( i=0; i<dim; i++ ){
+        uint64_t bit = (uint64_t)1 << ( dim-1-i );
+        uint64_t allowed = counts & ~( i+1 > half ? ( (uint64_t)1 << ( i+1-half ) ) - 1 : 0 );
+        for( tail=0; tail<TAILS; tail++ )
+            forward[i+1][tail] = 0;
+        for( tail=0; tail<TAILS; tail++ )
+            for( digit=0; digit<2; digit++ ){
+                int next = next_tail( tail, digit );
+                if( next < 0 || ( filled & bit && ( ( ones & bit ) != 0 ) != digit ) )
+                    continue;
+                forward[i+1][next] |= ( forward[i][tail] << digit ) & allowed;
+            }
+    }
+
+    // back from the end, where exactly dim/2 ONEs came before
+    for( tail=0; tail<TAILS; tail++ )
+        backward[tail] = dim % 2 == 0 ? (uint64_t)1 << half : 0;
+    for( i=dim-1; i>=0; i-- ){
+        uint64_t bit = (uint64_t)1 << ( dim-1-i );
+        for( tail=0; tail<TAILS; tail++ ){
+            earlier[tail] = 0;
+            for( digit=0; digit<2; digit++ ){
+                int next = next_tail( tail, digit );
+                if( next < 0 || ( filled & bit && ( ( ones & bit ) != 0 ) != digit ) )
+                    continue;
+                uint64_t through = forward[i][tail] & ( backward[next] >> digit );
+                earlier[tail] |= backward[next] >> digit;
+                if( through )
+                    can[digit] |= bit;
+            }
+        }
+        for( tail=0; tail<TAILS; tail++ )
+            backward[tail] = earlier[tail];
+    }
+
+    if( !( backward[START] & 1 ) ){
+        facts->zeros = facts->ones = ~(uint64_t)0;
+        return false;
+    }
+    facts->zeros = can[0] & ~can[1];
+    facts->ones = can[1] & ~can[0];
+    return true;
+}
+
+
+/// look up a line
+bool lookup_LineMemo( int dim, uint64_t filled, uint64_t ones, LineFacts* facts ){
+    size_t i;
+
+    assert( dim <= LINE_MEMO_MAX_DIM );
+
+    // a thread's first lookup makes its cache
+    if( memo == NULL ){
+        pthread_once( &memo_once, make_memo_key );
+        memo = calloc( 1, sizeof( LineMemo ) );
+        assert( memo );
+        pthread_setspecific( memo_key, memo );
+    }
+
+    // a new dimension starts an empty cache
+    if( memo->dim != dim ){
+        for( i=0; i<LINE_MEMO_SIZE; i++ ){
+            memo->table[i].filled = 0;
+            memo->table[i].ones = 1;
+        }
+        memo->dim = dim;
+        memo->counters.entries = 0;
+    }
+
+    // mix both masks into the top bits, which pick the bucket
+    uint64_t hash = filled * 0x9E3779B97F4A7C15ULL + ones;
+    hash ^= hash >> 32;
+    hash *= 0xC2B2AE3D27D4EB4FULL;
+    MemoEntry* bucket = &memo->table[( hash >> ( 64 - LINE_MEMO_BITS ) ) & ~(uint64_t)( LINE_MEMO_WAYS-1 )];
+
+    // a hit moves to the front of its bucket, and a miss replaces the back
+    for( i=0; i<LINE_MEMO_WAYS; i++ )
+        if( bucket[i].filled == filled && bucket[i].ones == ones )
+            break;
+    if( i < LINE_MEMO_WAYS ){
+        memo->counters.hits++;
+        *facts = bucket[i].facts;
+    }
+    else{
+        memo->counters.misses++;
+        i = LINE_MEMO_WAYS-1;
+        if( bucket[i].ones & ~bucket[i].filled )
+            memo->counters.entries++;
+        else
+            memo->counters.evictions++;
+        work_out( dim, filled, ones, facts );
+    }
+    for( ; i>0; i-- )
+        bucket[i] = bucket[i-1];
+    bucket[0].filled = filled;
+    bucket[0].ones = ones;
+    bucket[0].facts = *facts;
+
+    return !( facts->zeros & facts->ones );
+}
+
+
+/// the counters of the exited threads and the calling thread
+void stats_LineMemo( LineMemoStats* stats ){
+    if( memo != NULL )
+        *stats = memo->counters;
+    else
+        *stats = (LineMemoStats){ 0, 0, 0, 0 };
+    stats->hits += atomic_load_explicit( &exited_hits, memory_order_relaxed );
+    stats->misses += atomic_load_explicit( &exited_misses, memory_order_relaxed );
+    stats->evictions += atomic_load_explicit( &exited_evictions, memory_order_relaxed );
+}
+
+
+/// print the counters
+void print_LineMemoStats( const LineMemoStats* stats, FILE* stream ){
+    unsigned long long lookups = stats->hits + stats->misses;
+
+    fprintf( stream, "line memo: %llu hits, %llu misses (%.1f%% hit rate), %llu evictions, "
+             "%zu of %d entries in use\n", stats->hits, stats->misses,
+             lookups ? 100.0 * stats->hits / lookups : 0.0, stats->evictions, stats->entries,
+             LINE_MEMO_SIZE );
+}
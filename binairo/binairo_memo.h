@@ -0,0 +1,103 @@
+///
+/// file:
+///     binairo_memo.h
+///
+/// author:
+///     awallien
+///
+/// description:
+///     a bounded cache of what the line rules allow for partially
+///     filled rows and columns; a line's situation is keyed on the bits
+///     of its filled cells and of its cells holding ONE, so all rows
+///     and columns share entries, as do puzzles of the same dimension
+///     solved one after another on a thread
+///
+/// date:
+///     10/19/26
+///
+
+
+#ifndef __BINAIRO_MEMO_H_
+#define __BINAIRO_MEMO_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+
+/// longest line whose masks fit the cache's keys
+#define LINE_MEMO_MAX_DIM 64
+
+/// number of entries in each thread's cache, as a power of two
+#define LINE_MEMO_BITS 13
+#define LINE_MEMO_SIZE ( 1 << LINE_MEMO_BITS )
+
+/// entries of a bucket, which lines of the same hash share
+#define LINE_MEMO_WAYS 2
+
+
+/// the tail of a line after some cells, the state of the line passes
+/// of the memo and of the large-board solver
+/// START - no cell yet
+/// ZERO1, ZERO2 - ends in one or two ZEROs
+/// ONE1, ONE2 - ends in one or two ONEs
+enum Tail_e { START, ZERO1, ZERO2, ONE1, ONE2, TAILS };
+
+/// what a line's filled cells allow; both masks hold every cell of an
+/// infeasible line
+typedef struct LineFactsStruct {
+    uint64_t zeros;                 /// cells that are ZERO in every completion
+    uint64_t ones;                  /// cells that are ONE in every completion
+} LineFacts;
+
+/// counters of the line caches; hits, misses and evictions are summed
+/// over every thread that has exited and the calling thread
+typedef struct LineMemoStatsStruct {
+    unsigned long long hits;        /// lookups answered from the cache
+    unsigned long long misses;      /// lookups that had to be worked out
+    unsigned long long evictions;   /// entries overwritten by another line
+    size_t entries;                 /// entries in use in the calling thread's cache
+} LineMemoStats;
+
+
+///
+/// lookup_LineMemo
+///
+/// looks up, or works out and stores, which completions a line has
+/// under the rules of a single line: as many 0s as 1s and no three
+/// alike in a row; the cache is cleared when the dimension changes
+///
+/// @param dim - the line length, at most LINE_MEMO_MAX_DIM
+/// @param filled - the bits of the filled cells, first cell highest
+/// @param ones - the bits of the cells holding ONE
+/// @param facts - where the cells forced in every completion are
+///                stored, filled cells included
+///
+/// @return - true if the line can be completed; otherwise, false
+///
+bool lookup_LineMemo( int dim, uint64_t filled, uint64_t ones, LineFacts* facts );
+
+
+///
+/// stats_LineMemo
+///
+/// gathers the counters; a thread's lookups count once it has exited,
+/// so worker threads should be joined first
+///
+/// @param stats - where the counters are stored
+///
+void stats_LineMemo( LineMemoStats* stats );
+
+
+///
+/// print_LineMemoStats
+///
+/// prints a line of the counters and the hit rate
+///
+/// @param stats - the counters
+/// @param stream - the stream to write to
+///
+void print_LineMemoStats( const LineMemoStats* stats, FILE* stream );
+
+
+#endif //__BINAIRO_MEMO_H_
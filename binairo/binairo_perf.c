@@ -0,0 +1,257 @@
+///
+/// file:
+///     binairo_perf.c
+///
+/// author:
+///     awallien
+///
+/// description:
+///     implementation of the phase counters; the counters are opened as
+///     one group, so that a single read returns all of them at once,
+///     and each phase adds up the difference between its entry and exit
+///
+/// date:
+///     10/19/26
+///
+
+
+#define _DEFAULT_SOURCE
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#include "binairo_perf.h"
+
+
+/// the counters, in the order they are read
+enum PerfCounter_e { CYCLES, INSTRUCTIONS, L1D_MISSES, LLC_MISSES, BRANCH_MISSES, COUNTERS };
+
+/// names of the phases and the counters, as printed
+static const char* phase_names[PHASES] = { "parse", "validate", "propagate", "search", "output" };
+static const char* counter_names[COUNTERS] = { "cycles", "instructions", "L1D misses",
+                                               "LLC misses", "branch misses" };
+static const char* counter_columns[COUNTERS] = { "cycles", "instructions", "l1d_misses",
+                                                 "llc_misses", "branch_misses" };
+
+/// what a phase has added up
+typedef struct PerfTotalsStruct {
+    uint64_t counts[COUNTERS];      /// events counted inside the phase
+    uint64_t start[COUNTERS];       /// the counters when it was last entered
+    double seconds;                 /// wall-clock time inside the phase
+    struct timespec entered;        /// when it was last entered
+    unsigned long visits;           /// number of times it was entered
+} PerfTotals;
+
+/// totals of each phase, kept for the thread that opened the counters
+static PerfTotals totals[PHASES];
+
+/// is counting on, and on which thread
+static __thread bool counting = false;
+
+/// file descriptor of each counter, or -1 where it is not offered
+static int fds[COUNTERS] = { -1, -1, -1, -1, -1 };
+
+/// position of each counter in a group read, or -1
+static int slot[COUNTERS] = { -1, -1, -1, -1, -1 };
+
+/// number of counters in the group
+static int opened = 0;
+
+
+///
+/// read_counters
+///
+/// reads every counter of the group with one system call
+///
+/// @param values - where each counter's value is stored, by counter
+///
+static void read_counters( uint64_t values[COUNTERS] ){
+    uint64_t buffer[1 + COUNTERS];
+    int c;
+
+    memset( values, 0, COUNTERS * sizeof( uint64_t ) );
+    if( opened == 0 )
+        return;
+
+    // a group read returns the number of counters, then each value
+    if( read( fds[CYCLES] >= 0 ? fds[CYCLES] : fds[INSTRUCTIONS], buffer, sizeof( buffer ) ) <= 0 )
+        return;
+    for( c=0; c<COUNTERS; c++ )
+        if( slot[c] >= 0 )
+            values[c] = buffer[1 + slot[c]];
+}
+
+
+#ifdef __linux__
+///
+/// open_counter
+///
+/// opens one counter, joining the group led by the first one opened
+///
+/// @param counter - the counter
+/// @param type - its perf_event type
+/// @param config - its perf_event configuration
+/// @param stream - where to report a counter that could not be opened
+///
+static void open_counter( int counter, uint32_t type, uint64_t config, FILE* stream ){
+    struct perf_event_attr attr;
+    int leader = opened > 0 ? fds[CYCLES] >= 0 ? fds[CYCLES] : fds[INSTRUCTIONS] : -1;
+
+    memset( &attr, 0, sizeof( attr ) );
+    attr.size = sizeof( attr );
+    attr.type = type;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_GROUP;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.disabled = leader < 0;
+
+    fds[counter] = syscall( SYS_perf_event_open, &attr, 0, -1, leader, 0 );
+    if( fds[counter] < 0 ){
+        fprintf( stream, "perf: %s not counted (%s)\n", counter_names[counter], strerror( errno ) );
+        return;
+    }
+    slot[counter] = opened++;
+}
+#endif
+
+
+/// open the counters for this thread
+bool open_perf( FILE* stream ){
+    memset( totals, 0, sizeof( totals ) );
+    counting = true;
+
+#ifdef __linux__
+    open_counter( CYCLES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, stream );
+    open_counter( INSTRUCTIONS, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, stream );
+    if( opened > 0 ){
+        open_counter( L1D_MISSES, PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                      PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16,
+                      stream );
+        open_counter( LLC_MISSES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, stream );
+        open_counter( BRANCH_MISSES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, stream );
+
+        int leader = fds[CYCLES] >= 0 ? fds[CYCLES] : fds[INSTRUCTIONS];
+        ioctl( leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP );
+        ioctl( leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP );
+    }
+#else
+    fprintf( stream, "perf: hardware counters need Linux; timing phases only\n" );
+#endif
+
+    return opened > 0;
+}
+
+
+/// start a phase
+void enter_perf( PerfPhase phase ){
+    if( !counting )
+        return;
+    totals[phase].visits++;
+    clock_gettime( CLOCK_MONOTONIC, &totals[phase].entered );
+    read_counters( totals[phase].start );
+}
+
+
+/// end a phase
+void leave_perf( PerfPhase phase ){
+    uint64_t now[COUNTERS];
+    struct timespec left;
+    int c;
+
+    if( !counting )
+        return;
+    read_counters( now );
+    clock_gettime( CLOCK_MONOTONIC, &left );
+
+    for( c=0; c<COUNTERS; c++ )
+        totals[phase].counts[c] += now[c] - totals[phase].start[c];
+    totals[phase].seconds += ( left.tv_sec - totals[phase].entered.tv_sec ) +
+                             ( left.tv_nsec - totals[phase].entered.tv_nsec ) / 1e9;
+}
+
+
+/// print a table of the phases
+void print_perf( FILE* stream ){
+    int p, c;
+
+    fprintf( stream, "%-10s %8s %10s", "phase", "visits", "time (ms)" );
+    for( c=0; c<COUNTERS; c++ )
+        if( slot[c] >= 0 )
+            fprintf( stream, " %14s", counter_names[c] );
+    if( slot[CYCLES] >= 0 && slot[INSTRUCTIONS] >= 0 )
+        fprintf( stream, " %6s", "IPC" );
+    fputc( '\n', stream );
+
+    for( p=0; p<PHASES; p++ ){
+        if( totals[p].visits == 0 )
+            continue;
+        fprintf( stream, "%-10s %8lu %10.3f", phase_names[p], totals[p].visits,
+                 totals[p].seconds * 1e3 );
+        for( c=0; c<COUNTERS; c++ )
+            if( slot[c] >= 0 )
+                fprintf( stream, " %14llu", (unsigned long long)totals[p].counts[c] );
+        if( slot[CYCLES] >= 0 && slot[INSTRUCTIONS] >= 0 )
+            fprintf( stream, " %6.2f", totals[p].counts[CYCLES] ?
+                     (double)totals[p].counts[INSTRUCTIONS] / totals[p].counts[CYCLES] : 0.0 );
+        fputc( '\n', stream );
+    }
+}
+
+
+/// append the phases to a CSV file
+bool write_perf_csv( const char* path, const char* label ){
+    FILE* csv = fopen( path, "a" );
+    int p, c;
+
+    if( csv == NULL )
+        return false;
+
+    // a new file starts with the header
+    if( ftell( csv ) == 0 ){
+        fprintf( csv, "label,phase,visits,seconds" );
+        for( c=0; c<COUNTERS; c++ )
+            fprintf( csv, ",%s", counter_columns[c] );
+        fputc( '\n', csv );
+    }
+
+    // counters that could not be opened are left empty
+    for( p=0; p<PHASES; p++ ){
+        if( totals[p].visits == 0 )
+            continue;
+        fprintf( csv, "%s,%s,%lu,%.9f", label, phase_names[p], totals[p].visits, totals[p].seconds );
+        for( c=0; c<COUNTERS; c++ ){
+            if( slot[c] >= 0 )
+                fprintf( csv, ",%llu", (unsigned long long)totals[p].counts[c] );
+            else
+                fputc( ',', csv );
+        }
+        fputc( '\n', csv );
+    }
+
+    return fclose( csv ) == 0;
+}
+
+
+/// stop counting
+void close_perf( void ){
+    int c;
+
+    for( c=0; c<COUNTERS; c++ ){
+        if( fds[c] >= 0 )
+            close( fds[c] );
+        fds[c] = slot[c] = -1;
+    }
+    opened = 0;
+    counting = false;
+}
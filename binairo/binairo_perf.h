@@ -0,0 +1,109 @@
+///
+/// file:
+///     binairo_perf.h
+///
+/// author:
+///     awallien
+///
+/// description:
+///     hardware performance counters attributed to the solver's phases,
+///     read with perf_event_open around scoped region markers, to tell
+///     whether a phase is bound by cache misses, branch misses or
+///     instruction count
+///
+/// date:
+///     10/19/26
+///
+
+
+#ifndef __BINAIRO_PERF_H_
+#define __BINAIRO_PERF_H_
+
+#include <stdbool.h>
+#include <stdio.h>
+
+
+/// phases of a run, each a region between enter_perf and leave_perf
+/// PHASE_PARSE     - reading the board
+/// PHASE_VALIDATE  - checking the givens before the search
+/// PHASE_PROPAGATE - heuristics, line checks and probing at the root
+/// PHASE_SEARCH    - the backtracking kernels, and writing their result
+///                   onto the board
+/// PHASE_OUTPUT    - printing the solution
+enum PerfPhase_e { PHASE_PARSE, PHASE_VALIDATE, PHASE_PROPAGATE, PHASE_SEARCH,
+                   PHASE_OUTPUT, PHASES };
+typedef enum PerfPhase_e PerfPhase;
+
+
+///
+/// open_perf
+///
+/// starts counting cycles, instructions, L1 data cache read misses,
+/// last-level cache misses and branch misses for the calling thread;
+/// only regions entered on this thread are counted, and counters the
+/// hardware or kernel do not offer are left out
+///
+/// @param stream - where to report counters that could not be opened
+///
+/// @return - false if no counter could be opened, in which case only
+///           the time of each phase is kept; otherwise, true
+///
+bool open_perf( FILE* stream );
+
+
+///
+/// enter_perf
+///
+/// marks the start of a phase; does nothing unless open_perf was
+/// called on this thread
+///
+/// @param phase - the phase entered
+///
+void enter_perf( PerfPhase phase );
+
+
+///
+/// leave_perf
+///
+/// marks the end of a phase, adding what was counted since it was
+/// entered to its totals
+///
+/// @param phase - the phase left
+///
+void leave_perf( PerfPhase phase );
+
+
+///
+/// print_perf
+///
+/// prints a table of each phase's time and counts, along with its
+/// instructions per cycle
+///
+/// @param stream - the stream to print to
+///
+void print_perf( FILE* stream );
+
+
+///
+/// write_perf_csv
+///
+/// appends a row per phase to a CSV file, writing the header first if
+/// the file is new
+///
+/// @param path - the CSV file
+/// @param label - what was measured, such as the puzzle's file name
+///
+/// @return - false if the file could not be written; otherwise, true
+///
+bool write_perf_csv( const char* path, const char* label );
+
+
+///
+/// close_perf
+///
+/// stops counting on this thread
+///
+void close_perf( void );
+
+
+#endif //__BINAIRO_PERF_H_
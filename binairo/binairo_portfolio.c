@@ -0,0 +1,202 @@
+///
+/// file:
+///     binairo_portfolio.c
+///
+/// author:
+///     awallien
+///
+/// description:
+///     implementation of the portfolio solver; each thread runs the
+///     ordinary backtracker, whose state is per thread, on a copy of
+///     the board
+///
+/// date:
+///     10/19/26
+///
+
+
+#define _DEFAULT_SOURCE
+#include <assert.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "binairo_board.h"
+#include "binairo_bt.h"
+#include "binairo_portfolio.h"
+
+
+/// how often the waiting thread polls the caller's cancellation flag
+#define POLL_NSEC 10000000L
+
+
+/// state shared by the solvers of one portfolio
+typedef struct PortfolioStruct {
+    pthread_mutex_t lock;           /// guards the fields below
+    pthread_cond_t finished;        /// signalled as each solver finishes
+    atomic_int stop;                /// cancels every solver, set by whichever
+                                    /// thread finishes first
+    int running;                    /// number of solvers still running
+    int winner;                     /// first solver with an answer, or -1
+} Portfolio;
+
+/// a single solver of the portfolio
+typedef struct PortfolioTaskStruct {
+    Portfolio* portfolio;           /// the shared state
+    BinairoBoard board;             /// this solver's copy of the board
+    SolveOptions options;           /// this solver's limits and ordering
+    SolveResult result;             /// the outcome of its solve
+    CheckReport report;             /// why its board was rejected before the search
+    int id;                         /// index of the solver
+} PortfolioTask;
+
+
+///
+/// run_solver
+///
+/// thread body: solves the task's board and claims the win if it
+/// was the first to reach an answer
+///
+/// @param arg - the PortfolioTask
+///
+/// @return - NULL
+///
+static void* run_solver( void* arg ){
+    PortfolioTask* task = arg;
+    Portfolio* pf = task->portfolio;
+
+    bt_initialize( task->board, false, 0 );
+    task->result = solve_bounded( &task->options );
+
+    pthread_mutex_lock( &pf->lock );
+    if( task->result != GAVE_UP && pf->winner < 0 ){
+        pf->winner = task->id;
+        atomic_store_explicit( &pf->stop, 1, memory_order_relaxed );
+    }
+    pf->running--;
+    pthread_cond_signal( &pf->finished );
+    pthread_mutex_unlock( &pf->lock );
+
+    return NULL;
+}
+
+
+///
+/// filled_cells
+///
+/// @param board - a board
+///
+/// @return - the number of non-blank cells on the board
+///
+static int filled_cells( BinairoBoard board ){
+    int dim = dim_BinairoBoard( board );
+    int cell, count = 0;
+    for( cell=0; cell<dim*dim; cell++ )
+        if( get_BinairoBoard( board, cell ) != BLANK )
+            count++;
+    return count;
+}
+
+
+/// solve with a portfolio of threads
+SolveResult solve_portfolio( BinairoBoard board, int threads, const SolveOptions* options ){
+    static const SolveOptions none = { .cancel = NULL };
+    Portfolio pf;
+    PortfolioTask* tasks = calloc( threads, sizeof( PortfolioTask ) );
+    pthread_t* ids = calloc( threads, sizeof( pthread_t ) );
+    SolveOptions base = options != NULL ? *options : none;
+    struct timespec wake;
+    int i, pick, cell;
+
+    assert( tasks && ids && threads > 0 );
+
+    pthread_mutex_init( &pf.lock, NULL );
+    pthread_cond_init( &pf.finished, NULL );
+    atomic_init( &pf.stop, 0 );
+    pf.running = threads;
+    pf.winner = -1;
+
+    // the first solver runs as configured; the rest are seeded apart,
+    // and every other one restarts
+    for( i=0; i<threads; i++ ){
+        tasks[i].portfolio = &pf;
+        tasks[i].board = copy_BinairoBoard( board );
+        tasks[i].options = base;
+        tasks[i].options.cancel = &pf.stop;
+        tasks[i].options.report = &tasks[i].report;
+        tasks[i].id = i;
+        if( i > 0 ){
+            tasks[i].options.seed = base.seed + i;
+            tasks[i].options.restart_unit = i % 2 == 0 ? 0 :
+                    base.restart_unit ? base.restart_unit : PORTFOLIO_RESTART_UNIT;
+        }
+    }
+    // a solver that fails to start is no longer waited for; with none
+    // started, the first solver runs on this thread
+    int started = 0;
+    for( i=0; i<threads; i++ ){
+        if( pthread_create( &ids[i], NULL, run_solver, &tasks[i] ) != 0 ){
+            pthread_mutex_lock( &pf.lock );
+            pf.running -= threads - i;
+            pthread_mutex_unlock( &pf.lock );
+            break;
+        }
+        started++;
+    }
+    if( started == 0 ){
+        pf.running = 1;
+        run_solver( &tasks[0] );
+    }
+    int solvers = started > 0 ? started : 1;
+
+    // wait for the solvers, passing the caller's cancellation on to them
+    pthread_mutex_lock( &pf.lock );
+    while( pf.running > 0 ){
+        if( base.cancel != NULL && atomic_load_explicit( base.cancel, memory_order_relaxed ) )
+            atomic_store_explicit( &pf.stop, 1, memory_order_relaxed );
+        clock_gettime( CLOCK_REALTIME, &wake );
+        wake.tv_nsec += POLL_NSEC;
+        if( wake.tv_nsec >= 1000000000L ){
+            wake.tv_sec++;
+            wake.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait( &pf.finished, &pf.lock, &wake );
+    }
+    pthread_mutex_unlock( &pf.lock );
+
+    for( i=0; i<started; i++ )
+        pthread_join( ids[i], NULL );
+
+    // keep the winner, or the furthest partial board if all gave up
+    pick = pf.winner;
+    if( pick < 0 ){
+        pick = 0;
+        for( i=1; i<solvers; i++ )
+            if( filled_cells( tasks[i].board ) > filled_cells( tasks[pick].board ) )
+                pick = i;
+    }
+
+    int dim = dim_BinairoBoard( board );
+    for( cell=0; cell<dim*dim; cell++ ){
+        if( is_marked_BinairoBoard( board, cell ) )
+            continue;
+        put_BinairoBoard( board, cell, get_BinairoBoard( tasks[pick].board, cell ) );
+        if( is_proven_BinairoBoard( tasks[pick].board, cell ) )
+            prove_BinairoBoard( board, cell );
+    }
+
+    SolveResult res = tasks[pick].result;
+    if( base.report != NULL )
+        *base.report = tasks[pick].report;
+
+    for( i=0; i<threads; i++ )
+        destroy_BinairoBoard( tasks[i].board );
+    free( tasks );
+    free( ids );
+    pthread_mutex_destroy( &pf.lock );
+    pthread_cond_destroy( &pf.finished );
+
+    return res;
+}
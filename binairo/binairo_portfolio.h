@@ -0,0 +1,50 @@
+///
+/// file:
+///     binairo_portfolio.h
+///
+/// author:
+///     awallien
+///
+/// description:
+///     runs a portfolio of differently configured backtrackers on
+///     separate threads against the same puzzle and keeps the first
+///     answer
+///
+/// date:
+///     10/19/26
+///
+
+
+#ifndef __BINAIRO_PORTFOLIO_H_
+#define __BINAIRO_PORTFOLIO_H_
+
+#include "binairo_board.h"
+#include "binairo_bt.h"
+
+
+/// nodes per Luby restart unit for the portfolio's restarting solvers
+#define PORTFOLIO_RESTART_UNIT 256
+
+
+///
+/// solve_portfolio
+///
+/// solves the board with several backtrackers, each on its own thread
+/// and its own copy of the board; the first one uses the given options
+/// as they are, and the others are seeded differently, with every other
+/// one also restarting on the Luby sequence
+///
+/// as soon as one solver finds a solution or proves there is none, the
+/// others are cancelled and its board is copied onto the given board
+///
+/// @param board - the board to solve
+/// @param threads - the number of solvers to run
+/// @param options - the limits for every solver, and the ordering of the
+///                  first; NULL for none
+///
+/// @return SOLVED, NO_SOLUTION, or GAVE_UP if every solver gave up
+///
+SolveResult solve_portfolio( BinairoBoard board, int threads, const SolveOptions* options );
+
+
+#endif //__BINAIRO_PORTFOLIO_H_
@@ -0,0 +1,490 @@
+///
+/// file:
+///     binairo_py.c
+///
+/// author:
+///     awallien
+///
+/// description:
+///     CPython extension module exposing the solver in-process; boards
+///     are parsed and answers built while holding the interpreter lock,
+///     which is released for the searches themselves, so that Python
+///     threads, and the worker threads of a batch, solve in parallel
+///
+/// date:
+///     10/19/26
+///
+
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <assert.h>
+#include <ctype.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "binairo_board.h"
+#include "binairo_bt.h"
+#include "binairo_cnf.h"
+
+
+/// largest dimension accepted
+#define PY_MAX_DIM 1024
+
+/// raised, or returned by solve_many, when a limit is hit first
+static PyObject* GaveUp;
+
+/// a puzzle parsed from Python, and what became of it
+typedef struct PuzzleStruct {
+    char* cells;                    /// the cells row by row, '0', '1' or '.'
+    int dim;                        /// dimension of the board
+    BinairoBoard board;             /// the board, until it is solved
+    SolveResult result;             /// the outcome of the search
+} Puzzle;
+
+/// a batch of puzzles shared by its worker threads
+typedef struct BatchStruct {
+    Puzzle* puzzles;                /// the puzzles
+    Py_ssize_t count;               /// number of puzzles
+    Py_ssize_t next;                /// first puzzle not yet taken by a worker
+    pthread_mutex_t lock;           /// guards next
+    const SolveOptions* options;    /// the limits on each search
+} Batch;
+
+
+///
+/// collect_cells
+///
+/// copies the cells of a puzzle's text, skipping whitespace
+///
+/// @param text - the text
+/// @param len - its length
+/// @param cells - where the cells are stored, room for len of them
+/// @param limit - the text after this many cells is ignored
+///
+/// @return - the number of cells, or -1 with a Python exception set
+///
+static Py_ssize_t collect_cells( const char* text, Py_ssize_t len, char* cells, Py_ssize_t limit ){
+    Py_ssize_t i, n = 0;
+
+    for( i=0; i<len && n<limit; i++ ){
+        if( isspace( (unsigned char)text[i] ) )
+            continue;
+        if( text[i] != '0' && text[i] != '1' && text[i] != '.' ){
+            PyErr_Format( PyExc_ValueError, "invalid character '%c' in puzzle", text[i] );
+            return -1;
+        }
+        cells[n++] = text[i];
+    }
+    return n;
+}
+
+
+///
+/// board_of_cells
+///
+/// builds a board from its cells, laid out as a configuration file
+///
+/// @param cells - the cells row by row, '0', '1' or '.'
+/// @param dim - dimension of the board
+///
+/// @return - the board, or NULL if it could not be read
+///
+static BinairoBoard board_of_cells( const char* cells, int dim ){
+    int row, n;
+
+    // one row per line
+    char* text = malloc( 16 + dim*( dim+1 ) );
+    assert( text );
+    n = sprintf( text, "%d\n", dim );
+    for( row=0; row<dim; row++ ){
+        memcpy( text + n, cells + row*dim, dim );
+        n += dim;
+        text[n++] = '\n';
+    }
+
+    FILE* stream = fmemopen( text, n, "r" );
+    BinairoBoard board = stream != NULL ? create_BinairoBoard( stream ) : NULL;
+    if( stream != NULL )
+        fclose( stream );
+    free( text );
+    return board;
+}
+
+
+///
+/// parse_puzzle
+///
+/// reads a puzzle given as a str or a bytes-like object, either as a
+/// configuration file (the dimension, then one row per line) or as the
+/// cells alone, row by row, whitespace ignored, '.' for a blank, and
+/// builds its board, so that every puzzle that cannot be read fails
+/// here rather than in the search
+///
+/// @param object - the puzzle
+/// @param puzzle - where the cells and dimension are stored
+///
+/// @return - 0, or -1 with a Python exception set
+///
+static int parse_puzzle( PyObject* object, Puzzle* puzzle ){
+    Py_buffer view = { .buf = NULL };
+    const char* text;
+    Py_ssize_t len, i, n = -1;
+    long dim = 0;
+
+    if( PyUnicode_Check( object ) ){
+        text = PyUnicode_AsUTF8AndSize( object, &len );
+        if( text == NULL )
+            return -1;
+    }
+    else if( PyObject_GetBuffer( object, &view, PyBUF_SIMPLE ) == 0 ){
+        text = view.buf;
+        len = view.len;
+    }
+    else{
+        PyErr_Format( PyExc_TypeError, "a puzzle is a str or bytes-like object, not %.100s",
+                      Py_TYPE( object )->tp_name );
+        return -1;
+    }
+    puzzle->cells = malloc( len + 1 );
+    assert( puzzle->cells );
+
+    // a leading number is the dimension if the cells after it fill it;
+    // as in a configuration file, anything after the board is ignored
+    for( i=0; i<len && isspace( (unsigned char)text[i] ); i++ )
+        ;
+    Py_ssize_t start = i;
+    while( i<len && isdigit( (unsigned char)text[i] ) && dim <= PY_MAX_DIM )
+        dim = 10*dim + ( text[i++] - '0' );
+    if( i > start && i < len && isspace( (unsigned char)text[i] ) ){
+        n = collect_cells( text + i, len - i, puzzle->cells, dim*dim );
+        if( n < 0 )
+            PyErr_Clear( );
+    }
+
+    // otherwise, the cells alone must fill a square
+    if( n != dim*dim ){
+        n = collect_cells( text, len, puzzle->cells, len );
+        if( n < 0 )
+            goto fail;
+        for( dim=0; ( dim+1 )*( dim+1 ) <= n; dim++ )
+            ;
+    }
+    if( dim <= 1 || dim > PY_MAX_DIM || dim*dim != n ){
+        PyErr_Format( PyExc_ValueError, "puzzle has %zd cells, not a square of side 2 to %d",
+                      n, PY_MAX_DIM );
+        goto fail;
+    }
+
+    puzzle->dim = (int)dim;
+    puzzle->board = board_of_cells( puzzle->cells, puzzle->dim );
+    if( puzzle->board == NULL ){
+        PyErr_Format( PyExc_ValueError, "puzzle of side %ld could not be read as a board", dim );
+        goto fail;
+    }
+    if( view.buf != NULL )
+        PyBuffer_Release( &view );
+    return 0;
+
+fail:
+    free( puzzle->cells );
+    puzzle->cells = NULL;
+    if( view.buf != NULL )
+        PyBuffer_Release( &view );
+    return -1;
+}
+
+
+///
+/// solve_puzzle
+///
+/// solves a parsed puzzle on the calling thread, without touching any
+/// Python object; a solution replaces the puzzle's cells, and the board
+/// is freed
+///
+/// @param puzzle - the puzzle
+/// @param options - the limits on the search
+///
+static void solve_puzzle( Puzzle* puzzle, const SolveOptions* options ){
+    int cell;
+
+    bt_initialize( puzzle->board, false, 0 );
+    puzzle->result = solve_bounded( options );
+    if( puzzle->result == SOLVED )
+        for( cell=0; cell<puzzle->dim*puzzle->dim; cell++ )
+            puzzle->cells[cell] = get_BinairoBoard( puzzle->board, cell ) == ONE ? '1' : '0';
+    destroy_BinairoBoard( puzzle->board );
+    puzzle->board = NULL;
+}
+
+
+///
+/// batch_worker
+///
+/// takes puzzles from a batch until none are left
+///
+/// @param arg - the batch
+///
+/// @return - NULL
+///
+static void* batch_worker( void* arg ){
+    Batch* batch = arg;
+
+    for( ;; ){
+        pthread_mutex_lock( &batch->lock );
+        Py_ssize_t i = batch->next++;
+        pthread_mutex_unlock( &batch->lock );
+        if( i >= batch->count )
+            return NULL;
+        solve_puzzle( &batch->puzzles[i], batch->options );
+    }
+}
+
+
+///
+/// parse_options
+///
+/// fills in solve options from the keyword arguments shared by the
+/// module's functions
+///
+/// @param options - the options
+/// @param backend - "bt" or "cdcl"
+/// @param encoding - "seq" or "net"
+///
+/// @return - 0, or -1 with a Python exception set
+///
+static int parse_options( SolveOptions* options, const char* backend, const char* encoding ){
+    if( strcmp( backend, "cdcl" ) == 0 )
+        options->backend = CDCL;
+    else if( strcmp( backend, "bt" ) != 0 ){
+        PyErr_Format( PyExc_ValueError, "backend must be 'bt' or 'cdcl', not '%s'", backend );
+        return -1;
+    }
+    if( strcmp( encoding, "net" ) == 0 )
+        options->encoding = CARDINALITY_NETWORK;
+    else if( strcmp( encoding, "seq" ) != 0 ){
+        PyErr_Format( PyExc_ValueError, "encoding must be 'seq' or 'net', not '%s'", encoding );
+        return -1;
+    }
+    return 0;
+}
+
+
+///
+/// solution_object
+///
+/// builds the Python value of a solved puzzle
+///
+/// @param puzzle - the solved puzzle
+/// @param as_list - a list of rows of ints rather than bytes
+///
+/// @return - a new reference, or NULL with a Python exception set
+///
+static PyObject* solution_object( const Puzzle* puzzle, int as_list ){
+    int dim = puzzle->dim;
+    int row, col;
+
+    if( !as_list )
+        return PyBytes_FromStringAndSize( puzzle->cells, (Py_ssize_t)dim*dim );
+
+    PyObject* rows = PyList_New( dim );
+    if( rows == NULL )
+        return NULL;
+    for( row=0; row<dim; row++ ){
+        PyObject* line = PyList_New( dim );
+        if( line == NULL ){
+            Py_DECREF( rows );
+            return NULL;
+        }
+        for( col=0; col<dim; col++ )
+            PyList_SET_ITEM( line, col, PyLong_FromLong( puzzle->cells[row*dim + col] - '0' ) );
+        PyList_SET_ITEM( rows, row, line );
+    }
+    return rows;
+}
+
+
+/// solve one puzzle
+static PyObject* py_solve( PyObject* self, PyObject* args, PyObject* kwargs ){
+    static char* keywords[] = { "puzzle", "time_limit", "node_limit", "seed", "backend",
+                                "encoding", "as_list", NULL };
+    SolveOptions options = { .cancel = NULL };
+    const char* backend = "bt";
+    const char* encoding = "seq";
+    int as_list = 0;
+    PyObject* object;
+    Puzzle puzzle = { .cells = NULL };
+
+    (void)self;
+    if( !PyArg_ParseTupleAndKeywords( args, kwargs, "O|$dkkssp", keywords, &object,
+                                      &options.deadline, &options.max_nodes, &options.seed,
+                                      &backend, &encoding, &as_list ) )
+        return NULL;
+    if( parse_options( &options, backend, encoding ) < 0 || parse_puzzle( object, &puzzle ) < 0 )
+        return NULL;
+
+    Py_BEGIN_ALLOW_THREADS
+    solve_puzzle( &puzzle, &options );
+    Py_END_ALLOW_THREADS
+
+    PyObject* res = NULL;
+    if( puzzle.result == SOLVED )
+        res = solution_object( &puzzle, as_list );
+    else if( puzzle.result == NO_SOLUTION ){
+        Py_INCREF( Py_None );
+        res = Py_None;
+    }
+    else
+        PyErr_SetString( GaveUp, "a limit was hit before the search finished" );
+    free( puzzle.cells );
+    return res;
+}
+
+
+/// solve a list of puzzles on worker threads
+static PyObject* py_solve_many( PyObject* self, PyObject* args, PyObject* kwargs ){
+    static char* keywords[] = { "puzzles", "threads", "time_limit", "node_limit", "seed",
+                                "backend", "encoding", "as_list", NULL };
+    SolveOptions options = { .cancel = NULL };
+    const char* backend = "bt";
+    const char* encoding = "seq";
+    int as_list = 0, threads = 0, t;
+    PyObject* iterable;
+    PyObject* res = NULL;
+    Batch batch = { .puzzles = NULL };
+    Py_ssize_t i;
+
+    (void)self;
+    if( !PyArg_ParseTupleAndKeywords( args, kwargs, "O|$idkkssp", keywords, &iterable, &threads,
+                                      &options.deadline, &options.max_nodes, &options.seed,
+                                      &backend, &encoding, &as_list ) )
+        return NULL;
+    if( parse_options( &options, backend, encoding ) < 0 )
+        return NULL;
+
+    // every puzzle is parsed before any is solved, and the first that
+    // cannot be read fails the batch, its error naming its index
+    PyObject* seq = PySequence_Fast( iterable, "puzzles must be iterable" );
+    if( seq == NULL )
+        return NULL;
+    batch.count = PySequence_Fast_GET_SIZE( seq );
+    batch.puzzles = calloc( batch.count + 1, sizeof( Puzzle ) );
+    assert( batch.puzzles );
+    for( i=0; i<batch.count; i++ )
+        if( parse_puzzle( PySequence_Fast_GET_ITEM( seq, i ), &batch.puzzles[i] ) < 0 ){
+            PyObject *type, *value, *traceback;
+            PyErr_Fetch( &type, &value, &traceback );
+            PyErr_NormalizeException( &type, &value, &traceback );
+            PyErr_Format( type, "puzzle %zd of the batch: %S", i, value );
+            Py_XDECREF( type );
+            Py_XDECREF( value );
+            Py_XDECREF( traceback );
+            goto done;
+        }
+
+    if( threads <= 0 )
+        threads = (int)sysconf( _SC_NPROCESSORS_ONLN );
+    if( threads > batch.count )
+        threads = (int)batch.count;
+    if( threads < 1 )
+        threads = 1;
+    batch.options = &options;
+    pthread_mutex_init( &batch.lock, NULL );
+
+    // the calling thread works alongside the others; the workers are
+    // started for this call and joined before it returns, so no thread
+    // outlives the batch, and each worker's line memo and line table
+    // start empty and are freed when it exits
+    Py_BEGIN_ALLOW_THREADS
+    pthread_t workers[threads];
+    int started = 0;
+    for( t=1; t<threads; t++ )
+        if( pthread_create( &workers[started], NULL, batch_worker, &batch ) == 0 )
+            started++;
+    batch_worker( &batch );
+    for( t=0; t<started; t++ )
+        pthread_join( workers[t], NULL );
+    Py_END_ALLOW_THREADS
+
+    pthread_mutex_destroy( &batch.lock );
+
+    // a solution, None if unsolvable, or a GaveUp instance
+    res = PyList_New( batch.count );
+    for( i=0; res != NULL && i<batch.count; i++ ){
+        PyObject* item;
+        if( batch.puzzles[i].result == SOLVED )
+            item = solution_object( &batch.puzzles[i], as_list );
+        else if( batch.puzzles[i].result == NO_SOLUTION ){
+            Py_INCREF( Py_None );
+            item = Py_None;
+        }
+        else
+            item = PyObject_CallFunction( GaveUp, "s", "a limit was hit before the search finished" );
+        if( item == NULL )
+            Py_CLEAR( res );
+        else
+            PyList_SET_ITEM( res, i, item );
+    }
+
+done:
+    for( i=0; i<batch.count; i++ ){
+        free( batch.puzzles[i].cells );
+        if( batch.puzzles[i].board != NULL )
+            destroy_BinairoBoard( batch.puzzles[i].board );
+    }
+    free( batch.puzzles );
+    Py_DECREF( seq );
+    return res;
+}
+
+
+/// the module's functions
+static PyMethodDef methods[] = {
+    { "solve", (PyCFunction)(void(*)(void))py_solve, METH_VARARGS | METH_KEYWORDS,
+      "solve(puzzle, *, time_limit=0, node_limit=0, seed=0, backend='bt', encoding='seq',\n"
+      "      as_list=False)\n\n"
+      "Solve a puzzle, given as a str or bytes-like object: either a configuration\n"
+      "file's text or the cells alone, row by row, '.' for a blank. Returns the\n"
+      "solution as bytes of '0' and '1' row by row, or as a list of rows of ints,\n"
+      "or None if the puzzle has no solution. Raises GaveUp if a limit is hit first,\n"
+      "and ValueError if the puzzle cannot be read. The interpreter lock is released\n"
+      "while solving." },
+    { "solve_many", (PyCFunction)(void(*)(void))py_solve_many, METH_VARARGS | METH_KEYWORDS,
+      "solve_many(puzzles, *, threads=0, time_limit=0, node_limit=0, seed=0, backend='bt',\n"
+      "           encoding='seq', as_list=False)\n\n"
+      "Solve a list of puzzles on a pool of threads, one per core unless given,\n"
+      "with the limits applying to each puzzle. Returns a list holding, for each\n"
+      "puzzle, its solution as solve() would, None, or a GaveUp instance. Every\n"
+      "puzzle is read first; one that cannot be read raises ValueError, naming its\n"
+      "index, and nothing is solved. The threads are started by each call and\n"
+      "joined before it returns, so batches should be large enough to pay for them." },
+    { NULL, NULL, 0, NULL }
+};
+
+/// the module
+static struct PyModuleDef module = {
+    PyModuleDef_HEAD_INIT, "binairo", "The binairo solver, in-process.", -1, methods,
+    NULL, NULL, NULL, NULL
+};
+
+
+/// initialize the module
+PyMODINIT_FUNC PyInit_binairo( void ){
+    PyObject* mod = PyModule_Create( &module );
+    if( mod == NULL )
+        return NULL;
+
+    GaveUp = PyErr_NewException( "binairo.GaveUp", PyExc_TimeoutError, NULL );
+    Py_XINCREF( GaveUp );
+    if( GaveUp == NULL || PyModule_AddObject( mod, "GaveUp", GaveUp ) < 0 ){
+        Py_XDECREF( GaveUp );
+        Py_DECREF( mod );
+        return NULL;
+    }
+    return mod;
+}
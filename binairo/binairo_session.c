@@ -0,0 +1,748 @@
+///
+/// file:
+///     binairo_session.c
+///
+/// author:
+///     awallien
+///
+/// description:
+///     implementation of the interactive session; the deductions from
+///     the givens are kept in the order they were made, each one only
+///     depending on the row or column its rule looked at, so an edit
+///     retracts a deduction only if one of its lines changed
+///
+/// date:
+///     10/19/26
+///
+
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "binairo_board.h"
+#include "binairo_bt.h"
+#include "binairo_check.h"
+#include "binairo_session.h"
+#include "hash_info.h"
+
+
+/// a board being propagated, with its deductions
+typedef struct GridStruct {
+    int dim;                        /// dimension of the board
+    char* cells;                    /// one Digit per cell
+    int* row_count[2];              /// number of each digit in each row
+    int* col_count[2];              /// number of each digit in each column
+    int* queue;                     /// lines waiting to be propagated;
+                                    /// rows are 0..dim-1, columns dim..2*dim-1
+    bool* queued;                   /// is the line waiting?
+    int head;                       /// first waiting line in the queue
+    int waiting;                    /// number of waiting lines
+    Hint* deduced;                  /// deductions in the order they were made
+    int n_deduced;                  /// number of deductions
+} Grid;
+
+/// data structure for a session
+struct BinairoSessionStruct {
+    BinairoBoard board;             /// the caller's board
+    BinairoBoard puzzle;            /// the givens alone
+    int dim;                        /// dimension of the board
+    Grid view;                      /// the givens, as the player sees them
+    Grid state;                     /// the givens and their deductions
+    Grid scratch;                   /// for trying a digit on a cell
+    bool* dirty;                    /// lines changed by an edit
+    bool consistent;                /// no contradiction found in the givens
+    CheckReport report;             /// the contradiction found, if any
+    char* solution;                 /// the last solution found
+    bool solved;                    /// is there a last solution?
+};
+
+
+///
+/// line_id
+///
+/// @param dim - the board's dimension
+/// @param dir - the vector direction, either row or column
+/// @param idx - the row or column number
+///
+/// @return - the line's index in a grid's queue
+///
+static inline int line_id( int dim, Vector dir, int idx ){
+    return dir == ROW ? idx : dim + idx;
+}
+
+
+///
+/// line_cell
+///
+/// @param dim - the board's dimension
+/// @param dir - the vector direction, either row or column
+/// @param idx - the row or column number
+/// @param pos - the position along the line
+///
+/// @return - the cell at that position of the line
+///
+static inline int line_cell( int dim, Vector dir, int idx, int pos ){
+    return dir == ROW ? idx*dim + pos : pos*dim + idx;
+}
+
+
+///
+/// init_Grid
+///
+/// allocates an empty grid
+///
+/// @param g - the grid
+/// @param dim - the board's dimension
+///
+static void init_Grid( Grid* g, int dim ){
+    Digit d;
+
+    g->dim = dim;
+    g->cells = malloc( dim*dim * sizeof( char ) );
+    g->queue = malloc( 2*dim * sizeof( int ) );
+    g->queued = calloc( 2*dim, sizeof( bool ) );
+    g->deduced = malloc( dim*dim * sizeof( Hint ) );
+    assert( g->cells && g->queue && g->queued && g->deduced );
+    for( d=ZERO; d<=ONE; d++ ){
+        g->row_count[d] = calloc( dim, sizeof( int ) );
+        g->col_count[d] = calloc( dim, sizeof( int ) );
+        assert( g->row_count[d] && g->col_count[d] );
+    }
+
+    memset( g->cells, BLANK, dim*dim * sizeof( char ) );
+    g->head = g->waiting = g->n_deduced = 0;
+}
+
+
+///
+/// free_Grid
+///
+/// @param g - the grid to deallocate
+///
+static void free_Grid( Grid* g ){
+    Digit d;
+    for( d=ZERO; d<=ONE; d++ ){
+        free( g->row_count[d] );
+        free( g->col_count[d] );
+    }
+    free( g->cells );
+    free( g->queue );
+    free( g->queued );
+    free( g->deduced );
+}
+
+
+///
+/// copy_Grid
+///
+/// copies the cells of a grid, with no lines waiting and no deductions
+///
+/// @param dst - the grid copied onto
+/// @param src - the grid copied
+///
+static void copy_Grid( Grid* dst, const Grid* src ){
+    int dim = src->dim;
+    Digit d;
+
+    memcpy( dst->cells, src->cells, dim*dim * sizeof( char ) );
+    for( d=ZERO; d<=ONE; d++ ){
+        memcpy( dst->row_count[d], src->row_count[d], dim * sizeof( int ) );
+        memcpy( dst->col_count[d], src->col_count[d], dim * sizeof( int ) );
+    }
+    memset( dst->queued, false, 2*dim * sizeof( bool ) );
+    dst->head = dst->waiting = dst->n_deduced = 0;
+}
+
+
+///
+/// enqueue
+///
+/// @param g - the grid
+/// @param dir - the vector direction, either row or column
+/// @param idx - the row or column to propagate
+///
+static void enqueue( Grid* g, Vector dir, int idx ){
+    int id = line_id( g->dim, dir, idx );
+    if( g->queued[id] )
+        return;
+    g->queued[id] = true;
+    g->queue[( g->head + g->waiting++ ) % ( 2*g->dim )] = id;
+}
+
+
+///
+/// put_Grid
+///
+/// put a digit on the grid and update the row and column counters
+///
+/// @param g - the grid
+/// @param cell - the cell
+/// @param digit - the digit, possibly BLANK
+///
+static void put_Grid( Grid* g, int cell, Digit digit ){
+    int r = cell/g->dim, c = cell%g->dim;
+    Digit old = (Digit)g->cells[cell];
+
+    if( old != BLANK ){
+        g->row_count[old][r]--;
+        g->col_count[old][c]--;
+    }
+    if( digit != BLANK ){
+        g->row_count[digit][r]++;
+        g->col_count[digit][c]++;
+    }
+    g->cells[cell] = (char)digit;
+}
+
+
+///
+/// place
+///
+/// puts a digit on a blank cell and queues its row and column; a
+/// line it fills may now be copied, so every line of that direction
+/// is queued too
+///
+/// @param g - the grid
+/// @param cell - the blank cell
+/// @param digit - the digit
+///
+static void place( Grid* g, int cell, Digit digit ){
+    int dim = g->dim, r = cell/dim, c = cell%dim;
+    int j;
+
+    put_Grid( g, cell, digit );
+    enqueue( g, ROW, r );
+    enqueue( g, COL, c );
+
+    if( g->row_count[ZERO][r] + g->row_count[ONE][r] == dim )
+        for( j=0; j<dim; j++ )
+            enqueue( g, ROW, j );
+    if( g->col_count[ZERO][c] + g->col_count[ONE][c] == dim )
+        for( j=0; j<dim; j++ )
+            enqueue( g, COL, j );
+}
+
+
+///
+/// set_hint
+///
+/// @param h - where the deduction is stored
+/// @param cell - the forced cell
+/// @param digit - the digit it must hold
+/// @param rule - the rule that forced it
+/// @param dir - direction of the line the rule applied to
+/// @param line - that row or column
+/// @param other - the line copied, or -1
+///
+static void set_hint( Hint* h, int cell, Digit digit, DeductionRule rule,
+                      Vector dir, int line, int other ){
+    h->cell = cell;
+    h->digit = digit;
+    h->rule = rule;
+    h->dir = dir;
+    h->line = line;
+    h->other = other;
+}
+
+
+///
+/// ruled_out
+///
+/// checks whether a digit is ruled out for a blank cell by its row or
+/// column, trying the cheapest rule first
+///
+/// @param g - the grid
+/// @param cell - the blank cell
+/// @param digit - the digit to test
+/// @param why - where the resulting deduction, that the cell holds
+///              the other digit, is stored
+///
+/// @return - true if the digit cannot go in the cell; otherwise, false
+///
+static bool ruled_out( const Grid* g, int cell, Digit digit, Hint* why ){
+    int dim = g->dim, r = cell/dim, c = cell%dim;
+    const char* p = g->cells + cell;
+    char d = (char)digit;
+    Digit other = digit == ZERO ? ONE : ZERO;
+
+    if( ( c >= 2 && p[-1] == d && p[-2] == d ) || ( c+2 < dim && p[1] == d && p[2] == d ) ){
+        set_hint( why, cell, other, PAIR, ROW, r, -1 );
+        return true;
+    }
+    if( ( r >= 2 && p[-dim] == d && p[-2*dim] == d ) || ( r+2 < dim && p[dim] == d && p[2*dim] == d ) ){
+        set_hint( why, cell, other, PAIR, COL, c, -1 );
+        return true;
+    }
+    if( c >= 1 && c+1 < dim && p[-1] == d && p[1] == d ){
+        set_hint( why, cell, other, SANDWICH, ROW, r, -1 );
+        return true;
+    }
+    if( r >= 1 && r+1 < dim && p[-dim] == d && p[dim] == d ){
+        set_hint( why, cell, other, SANDWICH, COL, c, -1 );
+        return true;
+    }
+    if( g->row_count[digit][r] >= dim/2 ){
+        set_hint( why, cell, other, LINE_FULL, ROW, r, -1 );
+        return true;
+    }
+    if( g->col_count[digit][c] >= dim/2 ){
+        set_hint( why, cell, other, LINE_FULL, COL, c, -1 );
+        return true;
+    }
+    return false;
+}
+
+
+///
+/// copies_line
+///
+/// @param g - the grid
+/// @param dir - the vector direction, either row or column
+/// @param idx - a line with two blanks
+/// @param blank - the positions of the two blanks
+/// @param first - the digit for the first blank; the second gets the other
+/// @param other - a filled line
+///
+/// @return - true if filling the blanks so makes the line a copy of
+///           the other; otherwise, false
+///
+static bool copies_line( const Grid* g, Vector dir, int idx, const int* blank,
+                         Digit first, int other ){
+    int dim = g->dim, pos;
+
+    for( pos=0; pos<dim; pos++ ){
+        char mine = g->cells[line_cell( dim, dir, idx, pos )];
+        if( pos == blank[0] )
+            mine = (char)first;
+        else if( pos == blank[1] )
+            mine = (char)!first;
+        if( mine != g->cells[line_cell( dim, dir, other, pos )] )
+            return false;
+    }
+    return true;
+}
+
+
+///
+/// line_unique
+///
+/// a line with two blanks that still need one 0 and one 1 has two
+/// completions; if one copies a filled line, the other is forced
+///
+/// @param g - the grid
+/// @param dir - the vector direction, either row or column
+/// @param idx - the row or column number
+/// @param why - where the deduction for the first blank is stored
+///
+/// @return - true if the line's completion is forced; otherwise, false
+///
+static bool line_unique( const Grid* g, Vector dir, int idx, Hint* why ){
+    int dim = g->dim;
+    int* const* count = dir == ROW ? g->row_count : g->col_count;
+    int blank[2], n = 0, pos, j;
+    Digit first;
+
+    if( count[ZERO][idx] != dim/2-1 || count[ONE][idx] != dim/2-1 )
+        return false;
+    for( pos=0; pos<dim; pos++ )
+        if( g->cells[line_cell( dim, dir, idx, pos )] == BLANK )
+            blank[n++] = pos;
+
+    for( j=0; j<dim; j++ ){
+        if( j == idx || count[ZERO][j] + count[ONE][j] != dim )
+            continue;
+        for( first=ZERO; first<=ONE; first++ )
+            if( copies_line( g, dir, idx, blank, first, j ) ){
+                set_hint( why, line_cell( dim, dir, idx, blank[0] ), !first,
+                          LINE_UNIQUE, dir, idx, j );
+                return true;
+            }
+    }
+    return false;
+}
+
+
+///
+/// same_filled_lines
+///
+/// @param g - the grid
+/// @param dir - the vector direction, either row or column
+/// @param a - a row or column number
+/// @param b - another row or column number
+///
+/// @return - true if both lines are filled and alike; otherwise, false
+///
+static bool same_filled_lines( const Grid* g, Vector dir, int a, int b ){
+    int dim = g->dim, pos;
+
+    for( pos=0; pos<dim; pos++ ){
+        char d = g->cells[line_cell( dim, dir, a, pos )];
+        if( d == BLANK || d != g->cells[line_cell( dim, dir, b, pos )] )
+            return false;
+    }
+    return true;
+}
+
+
+///
+/// set_contradiction
+///
+/// @param report - where the contradiction is stored, or NULL
+/// @param rule - the rule broken
+/// @param dir - direction of the offending line
+/// @param line - the offending line, or -1
+/// @param other - the line it duplicates, or -1
+/// @param cell - the offending cell, or -1
+///
+static void set_contradiction( CheckReport* report, CheckRule rule, Vector dir,
+                               int line, int other, int cell ){
+    if( report == NULL )
+        return;
+    report->rule = rule;
+    report->dir = dir;
+    report->line = line;
+    report->other = other;
+    report->cell = cell;
+    report->digit = BLANK;
+}
+
+
+///
+/// propagate
+///
+/// applies the rules to the cells of each waiting line until no line
+/// waits, recording each deduction
+///
+/// @param g - the grid
+/// @param report - where a contradiction is stored, or NULL
+///
+/// @return - false if a contradiction was found; otherwise, true
+///
+static bool propagate( Grid* g, CheckReport* report ){
+    int dim = g->dim;
+    Hint no_zero, no_one, unique;
+
+    while( g->waiting > 0 ){
+        int id = g->queue[g->head];
+        Vector dir = id < dim ? ROW : COL;
+        int idx = id % dim, pos, j;
+
+        g->head = ( g->head + 1 ) % ( 2*dim );
+        g->waiting--;
+        g->queued[id] = false;
+
+        for( pos=0; pos<dim; pos++ ){
+            int cell = line_cell( dim, dir, idx, pos );
+            if( g->cells[cell] != BLANK )
+                continue;
+
+            bool zero_out = ruled_out( g, cell, ZERO, &no_zero );
+            bool one_out = ruled_out( g, cell, ONE, &no_one );
+
+            if( zero_out && one_out ){
+                set_contradiction( report, PROPAGATION, dir, idx, -1, cell );
+                return false;
+            }
+            if( zero_out || one_out ){
+                Hint* h = zero_out ? &no_zero : &no_one;
+                g->deduced[g->n_deduced++] = *h;
+                place( g, h->cell, h->digit );
+            }
+        }
+
+        int* const* count = dir == ROW ? g->row_count : g->col_count;
+        if( count[ZERO][idx] + count[ONE][idx] == dim ){
+            for( j=0; j<dim; j++ )
+                if( j != idx && same_filled_lines( g, dir, idx, j ) ){
+                    set_contradiction( report, LINE_DUPLICATE, dir, idx, j, -1 );
+                    return false;
+                }
+        }
+        else if( line_unique( g, dir, idx, &unique ) ){
+            g->deduced[g->n_deduced++] = unique;
+            place( g, unique.cell, unique.digit );
+        }
+    }
+    return true;
+}
+
+
+///
+/// rebuild
+///
+/// propagates the givens from scratch
+///
+/// @param s - the session
+///
+static void rebuild( BinairoSession s ){
+    int idx;
+
+    copy_Grid( &s->state, &s->view );
+    for( idx=0; idx<s->dim; idx++ ){
+        enqueue( &s->state, ROW, idx );
+        enqueue( &s->state, COL, idx );
+    }
+    s->consistent = check_BinairoBoard( s->puzzle, &s->report ) &&
+                    propagate( &s->state, &s->report );
+}
+
+
+///
+/// retract
+///
+/// blanks a cell, then, in the order they were made, every deduction
+/// whose rule looked at a line changed so far; each one retracted
+/// changes its own row and column in turn
+///
+/// @param s - the session
+/// @param cell - the cell whose given is removed
+///
+static void retract( BinairoSession s, int cell ){
+    Grid* g = &s->state;
+    int dim = s->dim;
+    int i, kept = 0, id;
+
+    memset( s->dirty, false, 2*dim * sizeof( bool ) );
+    put_Grid( g, cell, BLANK );
+    s->dirty[line_id( dim, ROW, cell/dim )] = s->dirty[line_id( dim, COL, cell%dim )] = true;
+
+    for( i=0; i<g->n_deduced; i++ ){
+        Hint* h = &g->deduced[i];
+        if( s->dirty[line_id( dim, h->dir, h->line )] ||
+                ( h->other >= 0 && s->dirty[line_id( dim, h->dir, h->other )] ) ){
+            put_Grid( g, h->cell, BLANK );
+            s->dirty[line_id( dim, ROW, h->cell/dim )] = true;
+            s->dirty[line_id( dim, COL, h->cell%dim )] = true;
+        }
+        else
+            g->deduced[kept++] = *h;
+    }
+    g->n_deduced = kept;
+
+    for( id=0; id<2*dim; id++ )
+        if( s->dirty[id] )
+            enqueue( g, id < dim ? ROW : COL, id % dim );
+}
+
+
+///
+/// assume
+///
+/// puts a new given on the deductions; if it was deduced already it
+/// only stops being a deduction
+///
+/// @param s - the session
+/// @param cell - the cell given
+/// @param digit - the given digit
+///
+static void assume( BinairoSession s, int cell, Digit digit ){
+    Grid* g = &s->state;
+    Digit cur = (Digit)g->cells[cell];
+    int i;
+
+    if( cur == BLANK )
+        place( g, cell, digit );
+    else if( cur != digit ){
+        s->consistent = false;
+        set_contradiction( &s->report, PROPAGATION, ROW, -1, -1, cell );
+    }
+    else for( i=0; i<g->n_deduced; i++ )
+        if( g->deduced[i].cell == cell ){
+            memmove( g->deduced + i, g->deduced + i + 1,
+                     ( g->n_deduced - i - 1 ) * sizeof( Hint ) );
+            g->n_deduced--;
+            break;
+        }
+}
+
+
+/// start a session on a board
+BinairoSession create_BinairoSession( BinairoBoard board ){
+    BinairoSession s = malloc( sizeof( struct BinairoSessionStruct ) );
+    int cell;
+
+    assert( s && board );
+    s->board = board;
+    s->puzzle = copy_BinairoBoard( board );
+    s->dim = dim_BinairoBoard( board );
+    clear_BinairoBoard( s->puzzle );
+
+    init_Grid( &s->view, s->dim );
+    init_Grid( &s->state, s->dim );
+    init_Grid( &s->scratch, s->dim );
+    s->dirty = malloc( 2*s->dim * sizeof( bool ) );
+    s->solution = malloc( s->dim*s->dim * sizeof( char ) );
+    s->solved = false;
+    assert( s->dirty && s->solution );
+
+    for( cell=0; cell<s->dim*s->dim; cell++ )
+        put_Grid( &s->view, cell, get_BinairoBoard( s->puzzle, cell ) );
+    rebuild( s );
+
+    return s;
+}
+
+
+/// free a session
+void destroy_BinairoSession( BinairoSession s ){
+    free_Grid( &s->view );
+    free_Grid( &s->state );
+    free_Grid( &s->scratch );
+    destroy_BinairoBoard( s->puzzle );
+    free( s->dirty );
+    free( s->solution );
+    free( s );
+}
+
+
+/// edit a given
+bool set_given_BinairoSession( BinairoSession s, int cell, Digit digit ){
+    Digit old = get_BinairoBoard( s->puzzle, cell );
+
+    if( old == digit )
+        return s->consistent;
+
+    give_BinairoBoard( s->puzzle, cell, digit );
+    give_BinairoBoard( s->board, cell, digit );
+    put_Grid( &s->view, cell, digit );
+
+    // after a contradiction the deductions are incomplete, so start over
+    if( !s->consistent ){
+        rebuild( s );
+        return s->consistent;
+    }
+
+    if( old != BLANK )
+        retract( s, cell );
+    if( digit != BLANK )
+        assume( s, cell, digit );
+
+    s->consistent = s->consistent && check_BinairoBoard( s->puzzle, &s->report ) &&
+                    propagate( &s->state, &s->report );
+    return s->consistent;
+}
+
+
+/// solve the session's puzzle
+SolveResult resolve_BinairoSession( BinairoSession s, const SolveOptions* options ){
+    CheckReport* report = options != NULL ? options->report : NULL;
+    int cell, i;
+    bool reuse = s->solved;
+
+    clear_BinairoBoard( s->board );
+    if( report != NULL )
+        report->rule = CONSISTENT;
+
+    if( !s->consistent ){
+        if( report != NULL )
+            *report = s->report;
+        return NO_SOLUTION;
+    }
+
+    // warm start: the last solution still holds if it agrees with every given
+    for( cell=0; reuse && cell<s->dim*s->dim; cell++ )
+        if( s->view.cells[cell] != BLANK && s->view.cells[cell] != s->solution[cell] )
+            reuse = false;
+    if( reuse ){
+        for( cell=0; cell<s->dim*s->dim; cell++ )
+            put_BinairoBoard( s->board, cell, (Digit)s->solution[cell] );
+        return SOLVED;
+    }
+
+    // otherwise search from the deductions
+    for( i=0; i<s->state.n_deduced; i++ ){
+        put_BinairoBoard( s->board, s->state.deduced[i].cell, s->state.deduced[i].digit );
+        prove_BinairoBoard( s->board, s->state.deduced[i].cell );
+    }
+
+    bt_initialize( s->board, false, 0 );
+    SolveResult res = solve_bounded( options );
+
+    if( res == SOLVED ){
+        for( cell=0; cell<s->dim*s->dim; cell++ )
+            s->solution[cell] = (char)get_BinairoBoard( s->board, cell );
+        s->solved = true;
+    }
+    return res;
+}
+
+
+/// find the next logical deduction
+bool hint_BinairoSession( BinairoSession s, Hint* hint ){
+    Grid* g = &s->view;
+    int dim = s->dim;
+    int cell, idx;
+    bool found = false;
+    Digit d;
+    Hint why;
+    Vector dir;
+
+    if( !s->consistent )
+        return false;
+
+    // the cheapest rule that forces some cell
+    for( cell=0; cell<dim*dim; cell++ ){
+        if( g->cells[cell] != BLANK )
+            continue;
+        for( d=ZERO; d<=ONE; d++ )
+            if( ruled_out( g, cell, d, &why ) && ( !found || why.rule < hint->rule ) ){
+                *hint = why;
+                found = true;
+                if( why.rule == PAIR )
+                    return true;
+            }
+    }
+    if( found )
+        return true;
+
+    for( dir=ROW; dir<=COL; dir++ )
+        for( idx=0; idx<dim; idx++ )
+            if( line_unique( g, dir, idx, hint ) )
+                return true;
+
+    // try each digit on each blank cell
+    for( cell=0; cell<dim*dim; cell++ ){
+        if( g->cells[cell] != BLANK )
+            continue;
+        for( d=ZERO; d<=ONE; d++ ){
+            copy_Grid( &s->scratch, g );
+            place( &s->scratch, cell, d );
+            if( !propagate( &s->scratch, NULL ) ){
+                set_hint( hint, cell, d == ZERO ? ONE : ZERO, LOOKAHEAD, ROW, -1, -1 );
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+
+/// print a deduction
+void print_Hint( const Hint* hint, int dim, FILE* stream ){
+    const char* line = hint->dir == ROW ? "row" : "column";
+    int other = hint->digit == ZERO ? 1 : 0;
+
+    fprintf( stream, "Row %d, column %d must be %d: ", hint->cell/dim + 1,
+             hint->cell%dim + 1, hint->digit );
+    switch( hint->rule ){
+        case PAIR:
+            fprintf( stream, "two adjacent %ds beside it in %s %d.\n", other, line, hint->line+1 );
+            break;
+        case SANDWICH:
+            fprintf( stream, "a %d on both sides of it in %s %d.\n", other, line, hint->line+1 );
+            break;
+        case LINE_FULL:
+            fprintf( stream, "%s %d already holds %d %ds.\n", line, hint->line+1, dim/2, other );
+            break;
+        case LINE_UNIQUE:
+            fprintf( stream, "the other completion of %s %d copies %s %d.\n",
+                     line, hint->line+1, line, hint->other+1 );
+            break;
+        case LOOKAHEAD:
+            fprintf( stream, "a %d there leads to a contradiction.\n", other );
+            break;
+    }
+}
@@ -0,0 +1,138 @@
+///
+/// file:
+///     binairo_session.h
+///
+/// author:
+///     awallien
+///
+/// description:
+///     keeps a puzzle's deductions and last solution alive while its
+///     givens are edited, for interactive play: each edit only redoes
+///     the deductions that depended on the changed row and column, and
+///     a hint query returns the next logical deduction without solving
+///
+/// date:
+///     10/19/26
+///
+
+
+#ifndef __BINAIRO_SESSION_H_
+#define __BINAIRO_SESSION_H_
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "binairo_board.h"
+#include "binairo_bt.h"
+#include "binairo_check.h"
+#include "hash_info.h"
+
+
+/// rule behind a deduction, cheapest first
+/// PAIR        - two adjacent identical digits beside the cell
+/// SANDWICH    - the same digit on both sides of the cell
+/// LINE_FULL   - the cell's line already holds dim/2 of the digit
+/// LINE_UNIQUE - the line has two blanks left, and one way of filling
+///               them copies another filled line
+/// LOOKAHEAD   - the other digit leads to a contradiction under the
+///               rules above
+enum DeductionRule_e { PAIR, SANDWICH, LINE_FULL, LINE_UNIQUE, LOOKAHEAD };
+typedef enum DeductionRule_e DeductionRule;
+
+/// a cell forced to hold a digit, and why
+typedef struct HintStruct {
+    int cell;                       /// the forced cell
+    Digit digit;                    /// the digit it must hold
+    DeductionRule rule;             /// the rule that forced it
+    Vector dir;                     /// direction of the line the rule applied to
+    int line;                       /// that row or column, or -1 for LOOKAHEAD
+    int other;                      /// the line copied, for LINE_UNIQUE; otherwise, -1
+} Hint;
+
+/// data structure declaration for a session
+typedef struct BinairoSessionStruct* BinairoSession;
+
+
+///
+/// create_BinairoSession
+///
+/// starts a session on a board, whose marked cells are the givens;
+/// the board then receives every edit and the result of every solve
+///
+/// @param board - the binairo board
+///
+/// @return - the session
+///
+BinairoSession create_BinairoSession( BinairoBoard board );
+
+
+///
+/// destroy_BinairoSession
+///
+/// frees the session, but not its board
+///
+/// @param session - the session to be freed
+///
+void destroy_BinairoSession( BinairoSession session );
+
+
+///
+/// set_given_BinairoSession
+///
+/// adds, changes or removes a given; the deductions that depended on
+/// the cell's row or column are retracted, and propagation resumes
+/// from the deductions left
+///
+/// @param session - the session
+/// @param cell - the cell edited
+/// @param digit - the new given, or BLANK to remove it
+///
+/// @return - false if the givens are now known to have no solution;
+///           otherwise, true
+///
+bool set_given_BinairoSession( BinairoSession session, int cell, Digit digit );
+
+
+///
+/// resolve_BinairoSession
+///
+/// solves the puzzle onto the session's board; the last solution is
+/// reused when it still agrees with every given, and otherwise the
+/// search starts from the session's deductions
+///
+/// @param session - the session
+/// @param options - the limits on the search; NULL for none
+///
+/// @return - the outcome, as for solve_bounded
+///
+SolveResult resolve_BinairoSession( BinairoSession session, const SolveOptions* options );
+
+
+///
+/// hint_BinairoSession
+///
+/// finds the blank cell forced by the cheapest rule from the givens
+/// alone, trying a digit on each cell (LOOKAHEAD) only when no other
+/// rule applies
+///
+/// @param session - the session
+/// @param hint - where the deduction is stored
+///
+/// @return - false if no cell is forced or the givens have no solution;
+///           otherwise, true
+///
+bool hint_BinairoSession( BinairoSession session, Hint* hint );
+
+
+///
+/// print_Hint
+///
+/// prints a deduction, with rows and columns numbered from 1
+///
+/// @param hint - the deduction
+/// @param dim - the dimension of the board
+/// @param stream - the stream to print to
+///
+void print_Hint( const Hint* hint, int dim, FILE* stream );
+
+
+#endif //__BINAIRO_SESSION_H_
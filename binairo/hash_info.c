@@ -72,6 +72,19 @@ void put_HashInfo( HashInfo hi, char* s, Vector dir, int vec ){
 }
 
 
+/// store a computed hash value into the hash collection
+void set_HashInfo( HashInfo hi, Vector dir, int vec, size_t hash ){
+	switch( dir ){
+		case ROW:
+			hi->hash_r[vec] = hash;
+			break;
+		case COL:
+			hi->hash_c[vec] = hash;
+			break;
+	}
+}
+
+
 /// get a hash value from hash collection
 size_t get_HashInfo( HashInfo hi, Vector dir, int vec ){
 	switch( dir ){
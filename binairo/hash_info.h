@@ -63,6 +63,19 @@ void destroy_HashInfo( HashInfo hashinfo );
 void put_HashInfo( HashInfo hashinfo, char* string, Vector direction, int index ); 
 
 
+///
+/// set_HashInfo
+///
+/// store an already computed hash value in the hash collection
+///
+/// @param hashinfo - the hash collection data structure
+/// @param direction - a vector direction, either row or column
+/// @param index - the row or column the hash value belongs to
+/// @param hash - the hash value
+///
+void set_HashInfo( HashInfo hashinfo, Vector direction, int index, size_t hash );
+
+
 ///
 /// get_HashInfo
 ///
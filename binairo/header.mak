@@ -1,4 +1,4 @@
 CXXFLAGS =	-ggdb
-CFLAGS =	-ggdb -Wall -Wextra -pedantic -std=c99
-CLIBFLAGS =	-lm
+CFLAGS =	-O2 -ggdb -Wall -Wextra -pedantic -std=c11
+CLIBFLAGS =	-lm -pthread
 CCLIBFLAGS =	
@@ -0,0 +1,47 @@
+#
+# file:
+#     setup.py
+#
+# author:
+#     awallien
+#
+# description:
+#     builds the binairo extension module in place with the system
+#     compiler:  python3 setup.py build_ext --inplace
+#
+# date:
+#     10/19/26
+#
+
+from setuptools import Extension, setup
+
+# the solver, without the command-line driver and its batch modes
+SOURCES = [
+    "binairo_py.c",
+    "binairo_board.c",
+    "binairo_bt.c",
+    "binairo_cdcl.c",
+    "binairo_check.c",
+    "binairo_cnf.c",
+    "binairo_large.c",
+    "binairo_memo.c",
+    "binairo_perf.c",
+    "display.c",
+    "get_line.c",
+    "hash_info.c",
+]
+
+# the board's constructor asserts on its allocations, so the asserts stay
+setup(
+    name="binairo",
+    version="1.0",
+    ext_modules=[
+        Extension(
+            "binairo",
+            sources=SOURCES,
+            extra_compile_args=["-std=c11", "-O2"],
+            undef_macros=["NDEBUG"],
+            extra_link_args=["-pthread"],
+        )
+    ],
+)
@@ -1,147 +1,206 @@
 """
 
-file: 
+file:
     connect4tie.py
 
-description: 
-    use backtracking to count the number of connect four tie boards
-    (there's probably a mathematical formula for this...)
+description:
+    count the number of connect four tie boards, full boards of 21 Xs
+    and 21 Os where neither has four in a row
 
-author: 
+    each player's pieces are a bitboard, 7 bits per column from the
+    bottom up with an empty bit on top, so four in a row is found by
+    shifting a bitboard onto itself; the boards are counted a column at
+    a time, by the last three columns placed and the number of Xs, since
+    every line of four across columns lies within four columns in a row
+
+author:
     awallien
 
-date: 
+date:
     4/25/19
 
-output: 
+output:
     713305820
 
 """
+from sys import argv
 
 """
-representation of the board
+dimensions of the board
 """
-board = [' ' for i in range(42)]
+WIDTH, HEIGHT = 7, 6
 
 """
-for counting the number of connect four tie board, Xs, and Os
+bits per column on a bitboard, the cells and an empty bit that keeps
+lines from wrapping into the next column
 """
-count = {"X": 0, "O": 0, "total": 0}
+STRIDE = HEIGHT + 1
 
 """
-check if all the values in list are the same value
+every cell of a column
 """
-_same = lambda lst: all(lst[0] == x for x in lst)
+COLUMN = (1 << HEIGHT) - 1
 
 """
-check if at least one of the three lists have the same value
+number of pieces each player has on a tie board
 """
-checkall = lambda i, j, k: _same(i) or _same(j) or _same(k)
+PIECES = WIDTH * HEIGHT // 2
 
 """
-When done populating the whole board, check if whole board is valid
+counts of boards by number of Xs are packed into one integer, the count
+of boards with k Xs at bit FIELD * k
 """
-is_goal = lambda i: i == 42 and count["X"] == count["O"]
+FIELD = 48
 
 
-def bt(i=0):
+def won(bits):
     """
-    Backtracking function to count all the connect four tie boards
-    :param i: the current index on the board
-    :return: True if goal is reached in backtracking; false otherwise
-             does not necessarily return anything if you think about it
+    checks for four in a row on a bitboard: shifting by one cell in a
+    direction and anding leaves the pairs in a row, and shifting those by
+    two cells and anding leaves the fours in a row
+    :param bits: the cells of one player
+    :return: True if four of them are in a row; otherwise, false
     """
-    global count
-    if is_goal(i):
-        return True
-    elif i < 42:
-        for c in ["X", "O"]:
-            board[i] = c
-            count[c] += 1
-            if is_valid(i) and bt(i + 1):
-                count["total"] += 1
-                print(to_string())
-            count[c] -= 1
-        board[i] = ' '
+    for shift in (1, STRIDE, STRIDE - 1, STRIDE + 1):
+        pairs = bits & (bits >> shift)
+        if pairs & (pairs >> 2 * shift):
+            return True
+    return False
 
-        if i == 0:
-            return False
 
+def bitboards(cols):
+    """
+    the bitboards of a run of full columns
+    :param cols: the X cells of each column, from the left
+    :return: the X bitboard and the O bitboard
+    """
+    x = o = 0
+    for i, c in enumerate(cols):
+        x |= c << STRIDE * i
+        o |= (COLUMN ^ c) << STRIDE * i
+    return x, o
 
-"""
-Following functions check for non-winning configurations on the board from a
-given 'i' index
 
-UR - upper right block of the board
-BL - bottom left area
-BR - bottom right area
-MC - middle column
 """
+full columns where neither player has four in a row, as their X cells
+"""
+columns = [c for c in range(1 << HEIGHT) if not any(won(b) for b in bitboards([c]))]
 
-
-def check_UR(i):
-    check_lst1 = board[i - 3:i + 1]
-    return _same(check_lst1)
-
-
-def check_BL(i):
-    check_lst2 = [board[i], board[i - 7], board[i - 14], board[i - 21]]
-    check_lst3 = [board[i], board[i - 6], board[i - 12], board[i - 18]]
-
-    return _same(check_lst2) or _same(check_lst3)
-
-
-def check_BR(i):
-    check_lst1 = board[i - 3:i + 1]
-    check_lst2 = [board[i], board[i - 7], board[i - 14], board[i - 21]]
-    check_lst3 = [board[i], board[i - 8], board[i - 16], board[i - 24]]
-
-    return checkall(check_lst1, check_lst2, check_lst3)
+"""
+number of Xs in each column
+"""
+xs = [bin(c).count("1") for c in range(1 << HEIGHT)]
 
 
-def check_MC(i):
-    if i in [3, 10, 17]:
-        return _same(board[i - 3:i + 1])
-    if i in [24, 31, 38]:
-        return check_BR(i) or _same([board[i], board[i - 6], board[i - 12], board[i - 18]])
+def follows():
+    """
+    the columns that can follow each three columns in a row without four
+    in a row across the four of them
+    :return: dictionary of the three columns to the list of next columns
+    """
+    res = dict()
+    for a in columns:
+        for b in columns:
+            for c in columns:
+                x, o = bitboards([a, b, c])
+                res[(a, b, c)] = [d for d in columns if not won(x | d << 3 * STRIDE) and
+                                  not won(o | (COLUMN ^ d) << 3 * STRIDE)]
+    return res
 
 
-def is_valid(i):
+def extend(boards, nxt):
     """
-    checks whether a piece put down on the board is a valid tie board
-    :param i: the index to put down a piece
-    :return: True if valid; otherwise, false
+    place another column on the right of every board
+    :param boards: dictionary of the last three columns to the counts of boards by Xs
+    :param nxt: the columns that can follow each three columns
+    :return: the same for the boards one column wider
     """
-    if i in [0, 1, 2, 7, 8, 9, 14, 15, 16]:
-        return True
-
-    if i in [4, 5, 6, 11, 12, 13, 18, 19, 20] and not check_UR(i):
-        return True
+    res = dict()
+    for (a, b, c), counts in boards.items():
+        for d in nxt[(a, b, c)]:
+            res[(b, c, d)] = res.get((b, c, d), 0) + (counts << FIELD * xs[d])
+    return res
 
-    if i in [21, 22, 23, 28, 29, 30, 35, 36, 37] and not check_BL(i):
-        return True
 
-    if i in [25, 26, 27, 32, 33, 34, 39, 40, 41] and not check_BR(i):
-        return True
+def count():
+    """
+    counts the tie boards: the boards of the four columns on the left are
+    counted by their last three, and by the left-right mirror, a tie board
+    mirrored is a tie board with the same columns reversed, so the same
+    counts give the boards of the four columns on the right by their first
+    three; a fifth column on the left half then joins the two halves
+    :return: the number of tie boards
+    """
+    nxt = follows()
+
+    # the three columns on the left, then the fourth
+    half = dict()
+    for a in columns:
+        for b in columns:
+            for c in columns:
+                half[(a, b, c)] = 1 << FIELD * (xs[a] + xs[b] + xs[c])
+    half = extend(half, nxt)
+    five = extend(half, nxt)
+
+    # columns 2, 3 and 4 shared, column 5 read off the mirrored half
+    total, field = 0, (1 << FIELD) - 1
+    for (c2, c3, c4), left in five.items():
+        right = 0
+        for c5 in nxt[(c2, c3, c4)]:
+            right += half.get((c5, c4, c3), 0)
+        if right == 0:
+            continue
+
+        # columns 3 and 4 are on both sides
+        need = PIECES + xs[c3] + xs[c4]
+        for k in range(need + 1):
+            ways = (left >> FIELD * k) & field
+            if ways:
+                total += ways * ((right >> FIELD * (need - k)) & field)
+    return total
+
+
+def boards():
+    """
+    generates every tie board, a column at a time
+    :return: generator of the X cells of each column of each board
+    """
+    nxt = follows()
+    cols = list()
 
-    if i in [3, 10, 17, 24, 31, 38] and not check_MC(i):
-        return True
+    def place(n):
+        if len(cols) == WIDTH:
+            if n == PIECES:
+                yield cols
+            return
+        left = WIDTH - len(cols) - 1
+        for c in nxt[tuple(cols[-3:])] if len(cols) >= 3 else columns:
+            if n + xs[c] <= PIECES <= n + xs[c] + HEIGHT * left:
+                cols.append(c)
+                yield from place(n + xs[c])
+                cols.pop()
 
-    return False
+    return place(0)
 
 
-def to_string():
+def to_string(cols):
     """
      string representation of the connect 4 board
     """
     res = ""
-    for i in range(6):
-        for j in range(7):
-            res += board[i * 7 + j]
+    for r in range(HEIGHT - 1, -1, -1):
+        for c in cols:
+            res += "X" if c >> r & 1 else "O"
         res += "\n"
-    return res[::-1]
+    return res
 
 
 if __name__ == '__main__':
-    bt()
-    print(count["total"])
+    if len(argv) > 1 and argv[1] == "print":
+        total = 0
+        for board in boards():
+            print(to_string(board))
+            total += 1
+        print(total)
+    else:
+        print(count())
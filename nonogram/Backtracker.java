@@ -1,4 +1,4 @@
-import java.io.*;
+import java.io.IOException;
 import java.util.Optional;
 
 /**
@@ -12,39 +12,48 @@ import java.util.Optional;
  */
 public class Backtracker {
     /*
-     * Should debug output be enabled?
+     * The trace of the search, or null if debugging is disabled
      */
-    private boolean debug;
+    private Tracer tracer;
 
     /**
      * Initialize a new backtracker
      *
-     * @param debug Is debugging output enabled?
+     * @param debug Is debugging output enabled? If so, every node is
+     *              traced to the file debug
      */
     public Backtracker(boolean debug) {
-        this.debug = debug;
-        if (this.debug) {
+        if (debug) {
+            try {
+                this.tracer = new Tracer("debug");
+            } catch (IOException e) {
+                e.printStackTrace();
+                System.exit(1);
+            }
             System.out.println("Backtracker debugging enabled...");
         }
     }
 
     /**
-     * A utility routine for printing out various debug messages.
+     * Initialize a new backtracker that traces its search
      *
-     * @param msg    The type of config being looked at (current, goal,
-     *               successor, e.g.)
-     * @param config The config to display
+     * @param tracer The trace to record the search on
      */
-    private void debugPrint(String msg, Configuration config) {
-        if (this.debug) {
-            try {
-                FileWriter outFile = new FileWriter("debug", true);
-                outFile.write(msg + ": " + config);
-                outFile.flush();
-            } catch (IOException e) {
-                e.printStackTrace();
-                System.exit(1);
-            }
+    public Backtracker(Tracer tracer) {
+        this.tracer = tracer;
+        System.out.println("Backtracker debugging enabled...");
+    }
+
+    /**
+     * A utility routine for tracing a configuration visited.
+     *
+     * @param depth  The depth of the config, 0 at the root
+     * @param kind   V, I or G for a valid, invalid or goal config
+     * @param config The config visited
+     */
+    private void debugPrint(int depth, char kind, Configuration config) {
+        if (this.tracer != null) {
+            tracer.visit(depth, kind, config);
         }
     }
 
@@ -55,20 +64,34 @@ public class Backtracker {
      * @return A solution config, or null if no solution
      */
     public Optional<Configuration> solve(Configuration config) {
-        debugPrint("Current config", config);
+        Optional<Configuration> sol = solve(config, 0);
+        if (this.tracer != null) {
+            tracer.report();
+        }
+        return sol;
+    }
+
+    /**
+     * Try find a solution under a configuration at some depth.
+     *
+     * @param config A valid configuration
+     * @param depth  Its depth, 0 at the root
+     * @return A solution config, or null if no solution
+     */
+    private Optional<Configuration> solve(Configuration config, int depth) {
         if (config.isGoal()) {
-            debugPrint("\tGoal config", config);
+            debugPrint(depth, 'G', config);
             return Optional.of(config);
         } else {
             for (Configuration child : config.getSuccessors()) {
                 if (child.isValid()) {
-                    debugPrint("\tValid successor", child);
-                    Optional<Configuration> sol = solve(child);
+                    debugPrint(depth + 1, 'V', child);
+                    Optional<Configuration> sol = solve(child, depth + 1);
                     if (sol.isPresent()) {
                         return sol;
                     }
                 } else {
-                    debugPrint("\tInvalid successor", child);
+                    debugPrint(depth + 1, 'I', child);
                 }
             }
             // implicit backtracking happens here
@@ -0,0 +1,185 @@
+import java.util.Arrays;
+
+/**
+ * The state of every column of the in-place search after each row: the
+ * run of marked cells reaching the row, the hint that run matches, and
+ * two bitmasks over the columns, of those whose next cell must be marked
+ * and of those whose next cell must be left blank. The state after each
+ * row is kept, so backing up to a row costs nothing, and placing a row
+ * works out the state after it from the state before it in O(columns).
+ *
+ * @author awallien (Alex Wall)
+ * @version 1.0
+ */
+public class ColumnState {
+
+    /**
+     * number of rows on the board
+     */
+    private final int rows;
+
+    /**
+     * number of columns on the board
+     */
+    private final int cols;
+
+    /**
+     * number of words in a row's bitmask
+     */
+    private final int words;
+
+    /**
+     * the block lengths of each column's hints
+     */
+    private final int[][] blocks;
+
+    /**
+     * need[c][h] is the number of rows column c takes to fit its blocks
+     * from block h on, gaps included
+     */
+    private final int[][] need;
+
+    /**
+     * length of each column's run reaching the last row placed, indexed
+     * [rows placed][column]
+     */
+    private final int[][] run;
+
+    /**
+     * index of the block each column's run matches, or of the next block
+     * to match without a run, indexed [rows placed][column]
+     */
+    private final int[][] hint;
+
+    /**
+     * columns whose next cell must be marked, indexed [rows placed][word]
+     */
+    private final long[][] mustFill;
+
+    /**
+     * columns whose next cell must be blank, indexed [rows placed][word]
+     */
+    private final long[][] mustEmpty;
+
+    /**
+     * Constructor, the state before any row is placed
+     *
+     * @param board - the board whose column hints to match
+     */
+    public ColumnState(NonoBoard board) {
+        this.rows = board.NUMBER_OF_ROWS;
+        this.cols = board.NUMBER_OF_COLS;
+        this.words = board.WORDS;
+        this.blocks = new int[cols][];
+        this.need = new int[cols][];
+        this.run = new int[rows + 1][cols];
+        this.hint = new int[rows + 1][cols];
+        this.mustFill = new long[rows + 1][words];
+        this.mustEmpty = new long[rows + 1][words];
+
+        for (int c = 0; c < cols; c++) {
+            blocks[c] = Placements.blocks(board.getColHints(c));
+            need[c] = new int[blocks[c].length + 1];
+            for (int h = blocks[c].length - 1; h >= 0; h--)
+                need[c][h] = blocks[c][h] + (h + 1 < blocks[c].length ? 1 + need[c][h + 1] : 0);
+
+            // a column without blocks stays blank from the start
+            if (blocks[c].length == 0)
+                mustEmpty[0][c >>> 6] |= 1L << (c & 63);
+        }
+    }
+
+    /**
+     * Constructor for the purpose of deep copying column states
+     *
+     * @param other - the column state to copy
+     */
+    public ColumnState(ColumnState other) {
+        this.rows = other.rows;
+        this.cols = other.cols;
+        this.words = other.words;
+        this.blocks = other.blocks;
+        this.need = other.need;
+        this.run = copy(other.run);
+        this.hint = copy(other.hint);
+        this.mustFill = copy(other.mustFill);
+        this.mustEmpty = copy(other.mustEmpty);
+    }
+
+    /**
+     * Check a placement of a row against the columns, and if it fits, work
+     * out the state after it; a column fails once its marked cells break
+     * its hints, or once its remaining blocks no longer fit in the rows
+     * left below, which on the last row means every block must be matched
+     *
+     * @param row  - the row placed, with every row above it placed
+     * @param bits - the placement, as a bitmask of the row
+     * @return true if every column can still match its hints; otherwise, false
+     */
+    public boolean place(int row, long[] bits) {
+        long[] fill = mustFill[row], empty = mustEmpty[row];
+
+        // every column at once, a word at a time
+        for (int w = 0; w < words; w++)
+            if ((bits[w] & empty[w]) != 0 || (fill[w] & ~bits[w]) != 0)
+                return false;
+
+        int[] runBefore = run[row], hintBefore = hint[row];
+        int[] runAfter = run[row + 1], hintAfter = hint[row + 1];
+        long[] fillAfter = mustFill[row + 1], emptyAfter = mustEmpty[row + 1];
+        int remaining = rows - row - 1;
+
+        Arrays.fill(fillAfter, 0);
+        Arrays.fill(emptyAfter, 0);
+        for (int c = 0; c < cols; c++) {
+            int[] b = blocks[c];
+            int r = runBefore[c], h = hintBefore[c];
+
+            if ((bits[c >>> 6] >>> (c & 63) & 1) != 0)
+                r++;
+            else if (r > 0) {
+                h++;
+                r = 0;
+            }
+
+            // the rest of the run and the blocks after it, or the blocks left
+            int needed = r > 0 ? b[h] - r + (h + 1 < b.length ? 1 + need[c][h + 1] : 0) : need[c][h];
+            if (needed > remaining)
+                return false;
+
+            runAfter[c] = r;
+            hintAfter[c] = h;
+            if (r > 0 && r < b[h])
+                fillAfter[c >>> 6] |= 1L << (c & 63);
+            else if (r > 0 || h == b.length)
+                emptyAfter[c >>> 6] |= 1L << (c & 63);
+        }
+        return true;
+    }
+
+    /**
+     * Helper function to copy the state after each row
+     *
+     * @param levels - the state to copy
+     * @return a new copy
+     */
+    private static int[][] copy(int[][] levels) {
+        int[][] copy = new int[levels.length][];
+        for (int i = 0; i < levels.length; i++)
+            copy[i] = levels[i].clone();
+        return copy;
+    }
+
+    /**
+     * Helper function to copy the masks after each row
+     *
+     * @param levels - the masks to copy
+     * @return a new copy
+     */
+    private static long[][] copy(long[][] levels) {
+        long[][] copy = new long[levels.length][];
+        for (int i = 0; i < levels.length; i++)
+            copy[i] = levels[i].clone();
+        return copy;
+    }
+}
@@ -29,4 +29,26 @@ public interface Configuration {
      * @return true if goal; false otherwise
      */
     boolean isGoal();
+
+    /**
+     * Get a configuration in the same state that shares nothing that the
+     * search changes with this one, so it can be searched on another
+     * thread. A configuration whose successors share no state with it is
+     * its own copy.
+     *
+     * @return an independent copy, or this configuration
+     */
+    default Configuration fork() {
+        return this;
+    }
+
+    /**
+     * A short label of the configuration for tracing a search, in place
+     * of its whole string
+     *
+     * @return the label, empty unless the puzzle gives one
+     */
+    default String traceLabel() {
+        return "";
+    }
 }
@@ -0,0 +1,264 @@
+import java.util.AbstractCollection;
+import java.util.Collection;
+import java.util.Collections;
+import java.util.Iterator;
+import java.util.NoSuchElementException;
+
+/**
+ * Configuration that searches on one board shared by every configuration
+ * of the search. A successor marks its row arrangement on the board in
+ * place when it is drawn from the collection, and the arrangement drawn
+ * before it is erased through the board's undo trail, so successors are
+ * drawn lazily, one arrangement at a time, by index into the placements
+ * the board built for the row when it was loaded.
+ * <p>
+ * A successor is therefore only current until the next one is drawn,
+ * which is exactly the order the Backtracker visits them in.
+ * <p>
+ * Line logic runs before the search and after every row is marked, so
+ * only placements that agree with the cells it has worked out are drawn,
+ * and a row it has fully solved has a single successor.
+ *
+ * @author awallien (Alex Wall)
+ * @version 1.0
+ */
+public class InPlaceConfig implements Configuration {
+
+    /**
+     * The board shared by the whole search
+     */
+    private final NonoBoard board;
+
+    /**
+     * The column state after each row, shared by the whole search
+     */
+    private final ColumnState columns;
+
+    /**
+     * The cells known by line logic, shared by the whole search
+     */
+    private final LineSolver lines;
+
+    /**
+     * Last row marked on the board, -1 before any
+     */
+    private final int status;
+
+    /**
+     * Index of the row's placement marked, -1 before any
+     */
+    private final int index;
+
+    /**
+     * Did the row marked fit the columns and the line logic that followed
+     */
+    private final boolean valid;
+
+    /**
+     * Constructor
+     *
+     * @param board - the initial board, which the search marks in place
+     */
+    public InPlaceConfig(NonoBoard board) {
+        this(board, new ColumnState(board), new LineSolver(board));
+    }
+
+    /**
+     * Constructor for the root, which works out what it can by line logic
+     * before the search starts
+     *
+     * @param board   - the initial board
+     * @param columns - its column state
+     * @param lines   - its line logic, with every line queued
+     */
+    private InPlaceConfig(NonoBoard board, ColumnState columns, LineSolver lines) {
+        this(board, columns, lines, -1, -1, lines.propagate());
+    }
+
+    /**
+     * Constructor for a successor, which shares its parent's board,
+     * column state and line logic
+     *
+     * @param board   - the shared board
+     * @param columns - the shared column state
+     * @param lines   - the shared line logic
+     * @param status  - the row the successor marked
+     * @param index   - the index of the row's placement
+     * @param valid   - did the row fit the columns and the line logic
+     */
+    private InPlaceConfig(NonoBoard board, ColumnState columns, LineSolver lines,
+                          int status, int index, boolean valid) {
+        this.board = board;
+        this.columns = columns;
+        this.lines = lines;
+        this.status = status;
+        this.index = index;
+        this.valid = valid;
+    }
+
+    /**
+     * The placements of the next row, each marked on the board as it is
+     * drawn from the collection
+     *
+     * @return a lazy collection of successors at the next row
+     */
+    @Override
+    public Collection<Configuration> getSuccessors() {
+        if (!valid)
+            return Collections.emptyList();
+
+        final int row = status + 1;
+        final long[][] table = board.getPlacements(row);
+
+        return new AbstractCollection<Configuration>() {
+            @Override
+            public Iterator<Configuration> iterator() {
+                return new Arrangements(row, table);
+            }
+
+            // the placements of the row, counting those the iterator skips
+            @Override
+            public int size() {
+                return table.length;
+            }
+        };
+    }
+
+    /**
+     * Validates the row marked against the columns, which was worked out
+     * incrementally from the rows above it when the row was drawn, and
+     * against the line logic that followed it
+     *
+     * @return true if valid configuration; otherwise, false
+     */
+    @Override
+    public boolean isValid() {
+        return valid;
+    }
+
+    /**
+     * Goal is reached once every row is marked
+     *
+     * @return true if reached; otherwise, false
+     */
+    @Override
+    public boolean isGoal() {
+        return status + 1 == board.NUMBER_OF_ROWS;
+    }
+
+    /**
+     * A copy on its own board, column state and line logic, so its subtree
+     * can be searched on another thread
+     *
+     * @return the copy
+     */
+    @Override
+    public Configuration fork() {
+        return new InPlaceConfig(new NonoBoard(board), new ColumnState(columns),
+                new LineSolver(lines), status, index, valid);
+    }
+
+    /**
+     * The row marked last and the index of its placement, for tracing a
+     * search
+     *
+     * @return the row and index
+     */
+    @Override
+    public String traceLabel() {
+        return status + " " + index;
+    }
+
+    /**
+     * String representation of Configuration object, the shared board as
+     * it currently stands
+     */
+    @Override
+    public String toString() {
+        return board.toString();
+    }
+
+    /**
+     * Iterator over the placements of a row that agree with its known
+     * cells, drawn from the board's table by index
+     */
+    private class Arrangements implements Iterator<Configuration> {
+
+        /**
+         * the row being arranged
+         */
+        private final int row;
+
+        /**
+         * the placements of the row
+         */
+        private final long[][] table;
+
+        /**
+         * trail length before the row was marked
+         */
+        private final int mark;
+
+        /**
+         * line logic trail length before the row was marked
+         */
+        private final int known;
+
+        /**
+         * index of the next placement to draw
+         */
+        private int next = 0;
+
+        /**
+         * Constructor
+         *
+         * @param row   - the row to arrange
+         * @param table - its placements
+         */
+        Arrangements(int row, long[][] table) {
+            this.row = row;
+            this.table = table;
+            this.mark = board.trailMark();
+            this.known = lines.trailMark();
+        }
+
+        /**
+         * Is there another placement? The placement drawn last and what
+         * followed from it are erased first, leaving the board and the
+         * known cells as the parent configuration had them, and the
+         * placements that disagree with those cells are skipped
+         *
+         * @return true if there is; otherwise, false
+         */
+        @Override
+        public boolean hasNext() {
+            board.undo(mark);
+            lines.undo(known);
+            while (next < table.length && !lines.agrees(row, table[next]))
+                next++;
+            return next < table.length;
+        }
+
+        /**
+         * Mark the next placement on the board, place it on the column
+         * state, and work out what follows from it by line logic
+         *
+         * @return the successor with this placement
+         */
+        @Override
+        public Configuration next() {
+            if (!hasNext())
+                throw new NoSuchElementException();
+
+            int drawn = next++;
+            long[] bits = table[drawn];
+            board.markLogged(row, bits);
+            boolean fits = columns.place(row, bits);
+            if (fits) {
+                lines.assign(row, bits);
+                fits = lines.propagate();
+            }
+            return new InPlaceConfig(board, columns, lines, row, drawn, fits);
+        }
+    }
+}
@@ -0,0 +1,424 @@
+import java.util.Arrays;
+
+/**
+ * Line logic over the whole board: for every row and column, the cells
+ * known to be marked and known to be blank, and a solver that works out
+ * from a line's hints and its known cells which of its unknown cells are
+ * marked, or blank, in every arrangement of the line that agrees with
+ * them. A line whose cells change puts the lines crossing it on a queue,
+ * and lines are solved off the queue until no more cells follow.
+ * <p>
+ * Cells become known through an undo trail, like the board's, so the
+ * search can back up to any earlier state.
+ *
+ * @author awallien (Alex Wall)
+ * @version 1.0
+ */
+public class LineSolver {
+
+    /**
+     * number of rows on the board
+     */
+    private final int rows;
+
+    /**
+     * number of columns on the board
+     */
+    private final int cols;
+
+    /**
+     * number of words in a row's bitmask
+     */
+    private final int words;
+
+    /**
+     * the block lengths of each row's hints
+     */
+    private final int[][] rowBlocks;
+
+    /**
+     * the block lengths of each column's hints
+     */
+    private final int[][] colBlocks;
+
+    /**
+     * cells known to be marked, a bitmask per row
+     */
+    private final long[][] filled;
+
+    /**
+     * cells known to be blank, a bitmask per row
+     */
+    private final long[][] empty;
+
+    /**
+     * words changed, as row * words + word, in the order they changed
+     */
+    private int[] trail = new int[64];
+
+    /**
+     * the marked cells of each word on the trail before it changed
+     */
+    private long[] trailFilled = new long[64];
+
+    /**
+     * the blank cells of each word on the trail before it changed
+     */
+    private long[] trailEmpty = new long[64];
+
+    /**
+     * number of words on the trail
+     */
+    private int trailSize = 0;
+
+    /**
+     * lines waiting to be solved, rows as their index and columns as
+     * rows + their index, in a ring
+     */
+    private final int[] queue;
+
+    /**
+     * is each line on the queue
+     */
+    private final boolean[] queued;
+
+    /**
+     * position of the first line on the queue
+     */
+    private int head = 0;
+
+    /**
+     * number of lines on the queue
+     */
+    private int queueSize = 0;
+
+    /**
+     * scratch for the line being solved: its known marked and blank cells,
+     * and the cells marked or blank in some arrangement
+     */
+    private final boolean[] knownFill, knownEmpty, canFill, canEmpty;
+
+    /**
+     * scratch: blank cells known before each cell of the line, and the
+     * running count of arrangements' blocks starting and ending at a cell
+     */
+    private final int[] blanksBefore, fillStarts;
+
+    /**
+     * scratch: fits[i][j] is whether blocks j on fit in the cells from i
+     * on, and reach[i][j] whether the cells before i fit the blocks before j
+     */
+    private final boolean[][] fits, reach;
+
+    /**
+     * Constructor, with no cells known and every line on the queue
+     *
+     * @param board - the board whose hints to solve
+     */
+    public LineSolver(NonoBoard board) {
+        this.rows = board.NUMBER_OF_ROWS;
+        this.cols = board.NUMBER_OF_COLS;
+        this.words = board.WORDS;
+        this.rowBlocks = new int[rows][];
+        this.colBlocks = new int[cols][];
+        this.filled = new long[rows][words];
+        this.empty = new long[rows][words];
+        this.queue = new int[rows + cols];
+        this.queued = new boolean[rows + cols];
+
+        int longest = Math.max(rows, cols), most = 0;
+        for (int r = 0; r < rows; r++) {
+            rowBlocks[r] = Placements.blocks(board.getRowHints(r));
+            most = Math.max(most, rowBlocks[r].length);
+        }
+        for (int c = 0; c < cols; c++) {
+            colBlocks[c] = Placements.blocks(board.getColHints(c));
+            most = Math.max(most, colBlocks[c].length);
+        }
+
+        knownFill = new boolean[longest];
+        knownEmpty = new boolean[longest];
+        canFill = new boolean[longest];
+        canEmpty = new boolean[longest];
+        blanksBefore = new int[longest + 1];
+        fillStarts = new int[longest + 1];
+        fits = new boolean[longest + 1][most + 1];
+        reach = new boolean[longest + 1][most + 1];
+
+        for (int line = 0; line < rows + cols; line++)
+            enqueue(line);
+    }
+
+    /**
+     * Constructor for the purpose of deep copying line logic; the copy
+     * knows the same cells and queues the same lines, with an empty trail
+     *
+     * @param other - the line logic to copy
+     */
+    public LineSolver(LineSolver other) {
+        this.rows = other.rows;
+        this.cols = other.cols;
+        this.words = other.words;
+        this.rowBlocks = other.rowBlocks;
+        this.colBlocks = other.colBlocks;
+        this.filled = new long[rows][];
+        this.empty = new long[rows][];
+        for (int r = 0; r < rows; r++) {
+            filled[r] = other.filled[r].clone();
+            empty[r] = other.empty[r].clone();
+        }
+        this.queue = new int[rows + cols];
+        this.queued = new boolean[rows + cols];
+        for (int i = 0; i < other.queueSize; i++)
+            enqueue(other.queue[(other.head + i) % queue.length]);
+
+        int longest = other.knownFill.length, most = other.fits[0].length;
+        knownFill = new boolean[longest];
+        knownEmpty = new boolean[longest];
+        canFill = new boolean[longest];
+        canEmpty = new boolean[longest];
+        blanksBefore = new int[longest + 1];
+        fillStarts = new int[longest + 1];
+        fits = new boolean[longest + 1][most];
+        reach = new boolean[longest + 1][most];
+    }
+
+    /**
+     * Does a placement of a row agree with the cells known on it
+     *
+     * @param row  - the row
+     * @param bits - the placement, as a bitmask of the row
+     * @return true if it does; otherwise, false
+     */
+    public boolean agrees(int row, long[] bits) {
+        for (int w = 0; w < words; w++)
+            if ((bits[w] & empty[row][w]) != 0 || (filled[row][w] & ~bits[w]) != 0)
+                return false;
+        return true;
+    }
+
+    /**
+     * Make every cell of a row known, as the search placed it, and queue
+     * the columns it changed
+     *
+     * @param row  - the row
+     * @param bits - the placement, as a bitmask of the row
+     */
+    public void assign(int row, long[] bits) {
+        for (int c = 0; c < cols; c++) {
+            if ((bits[c >>> 6] >>> (c & 63) & 1) != 0)
+                learn(row, c, true, rows + c);
+            else
+                learn(row, c, false, rows + c);
+        }
+    }
+
+    /**
+     * Solve lines off the queue until no more cells follow
+     *
+     * @return false if a line can no longer be arranged; otherwise, true
+     */
+    public boolean propagate() {
+        while (queueSize > 0) {
+            int line = queue[head];
+            queued[line] = false;
+            head = (head + 1) % queue.length;
+            queueSize--;
+
+            if (!solve(line)) {
+                while (queueSize > 0) {
+                    queued[queue[head]] = false;
+                    head = (head + 1) % queue.length;
+                    queueSize--;
+                }
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Get the current length of the undo trail, to restore back to later
+     *
+     * @return the number of words on the trail
+     */
+    public int trailMark() {
+        return trailSize;
+    }
+
+    /**
+     * Forget the cells learned since the trail had the given length
+     *
+     * @param mark a length returned by trailMark
+     */
+    public void undo(int mark) {
+        while (trailSize > mark) {
+            int word = trail[--trailSize];
+            filled[word / words][word % words] = trailFilled[trailSize];
+            empty[word / words][word % words] = trailEmpty[trailSize];
+        }
+    }
+
+    /**
+     * Helper function to put a line on the queue, if not on it already
+     *
+     * @param line - the line, a row or rows + a column
+     */
+    private void enqueue(int line) {
+        if (!queued[line]) {
+            queued[line] = true;
+            queue[(head + queueSize++) % queue.length] = line;
+        }
+    }
+
+    /**
+     * Helper function to make a cell known, logging its word on the trail
+     * and queueing the crossing line if the cell was unknown
+     *
+     * @param row    - the row of the cell
+     * @param col    - the column of the cell
+     * @param marked - true if marked; otherwise, false if blank
+     * @param across - the line crossing the one the cell was learned on
+     */
+    private void learn(int row, int col, boolean marked, int across) {
+        int w = col >>> 6;
+        long bit = 1L << (col & 63);
+        if (((filled[row][w] | empty[row][w]) & bit) != 0)
+            return;
+
+        if (trailSize == trail.length) {
+            trail = Arrays.copyOf(trail, 2 * trail.length);
+            trailFilled = Arrays.copyOf(trailFilled, 2 * trailFilled.length);
+            trailEmpty = Arrays.copyOf(trailEmpty, 2 * trailEmpty.length);
+        }
+        trail[trailSize] = row * words + w;
+        trailFilled[trailSize] = filled[row][w];
+        trailEmpty[trailSize++] = empty[row][w];
+
+        if (marked)
+            filled[row][w] |= bit;
+        else
+            empty[row][w] |= bit;
+        enqueue(across);
+    }
+
+    /**
+     * Helper function to solve a line: read its known cells, work out the
+     * cells every arrangement agrees on, and learn the new ones
+     *
+     * @param line - the line, a row or rows + a column
+     * @return false if no arrangement agrees with the known cells; otherwise, true
+     */
+    private boolean solve(int line) {
+        boolean isRow = line < rows;
+        int index = isRow ? line : line - rows;
+        int length = isRow ? cols : rows;
+
+        for (int i = 0; i < length; i++) {
+            int row = isRow ? index : i, col = isRow ? i : index;
+            long bit = 1L << (col & 63);
+            knownFill[i] = (filled[row][col >>> 6] & bit) != 0;
+            knownEmpty[i] = (empty[row][col >>> 6] & bit) != 0;
+        }
+
+        if (!arrange(isRow ? rowBlocks[index] : colBlocks[index], length))
+            return false;
+
+        for (int i = 0; i < length; i++) {
+            if (knownFill[i] || knownEmpty[i] || canFill[i] == canEmpty[i])
+                continue;
+            if (isRow)
+                learn(index, i, canFill[i], rows + i);
+            else
+                learn(i, index, canFill[i], i);
+        }
+        return true;
+    }
+
+    /**
+     * Helper function to find, over every arrangement of the blocks that
+     * agrees with the known cells of the line, the cells marked in some
+     * arrangement and the cells blank in some arrangement
+     *
+     * @param blocks - the block lengths of the line
+     * @param length - the length of the line
+     * @return false if no arrangement agrees; otherwise, true
+     */
+    private boolean arrange(int[] blocks, int length) {
+        int k = blocks.length;
+
+        for (int i = 0; i < length; i++)
+            blanksBefore[i + 1] = blanksBefore[i] + (knownEmpty[i] ? 1 : 0);
+
+        // from the end of the line back: do blocks j on fit from cell i on
+        for (int j = 0; j <= k; j++)
+            fits[length][j] = j == k;
+        for (int i = length - 1; i >= 0; i--) {
+            for (int j = 0; j <= k; j++) {
+                boolean fit = !knownFill[i] && fits[i + 1][j];
+                if (!fit && j < k)
+                    fit = blockFits(blocks[j], i, length) &&
+                            fits[Math.min(i + blocks[j] + 1, length)][j + 1];
+                fits[i][j] = fit;
+            }
+        }
+        if (!fits[0][0])
+            return false;
+
+        // from the start forward, over the states some arrangement reaches
+        for (int i = 0; i <= length; i++) {
+            Arrays.fill(reach[i], 0, k + 1, false);
+            fillStarts[i] = 0;
+        }
+        Arrays.fill(canEmpty, 0, length, false);
+        reach[0][0] = true;
+        for (int i = 0; i < length; i++) {
+            for (int j = 0; j <= k; j++) {
+                if (!reach[i][j])
+                    continue;
+
+                // cell i blank
+                if (!knownFill[i] && fits[i + 1][j]) {
+                    canEmpty[i] = true;
+                    reach[i + 1][j] = true;
+                }
+
+                // block j starting at cell i, then the blank after it
+                if (j < k && blockFits(blocks[j], i, length)) {
+                    int end = i + blocks[j];
+                    int next = Math.min(end + 1, length);
+                    if (fits[next][j + 1]) {
+                        fillStarts[i]++;
+                        fillStarts[end]--;
+                        if (end < length)
+                            canEmpty[end] = true;
+                        reach[next][j + 1] = true;
+                    }
+                }
+            }
+        }
+
+        int covering = 0;
+        for (int i = 0; i < length; i++) {
+            covering += fillStarts[i];
+            canFill[i] = covering > 0;
+        }
+        return true;
+    }
+
+    /**
+     * Helper function to check a block can start at a cell: it stays on
+     * the line, covers no known blank, and is not followed by a known
+     * marked cell
+     *
+     * @param block  - the block length
+     * @param start  - the cell it starts at
+     * @param length - the length of the line
+     * @return true if it can; otherwise, false
+     */
+    private boolean blockFits(int block, int start, int length) {
+        int end = start + block;
+        return end <= length && blanksBefore[end] == blanksBefore[start] &&
+                (end == length || !knownFill[end]);
+    }
+}
@@ -1,6 +1,7 @@
 import java.io.File;
 import java.io.FileNotFoundException;
 import java.util.ArrayList;
+import java.util.Arrays;
 import java.util.Scanner;
 
 /**
@@ -13,9 +14,10 @@ import java.util.Scanner;
 public class NonoBoard {
 
     /**
-     * representation of puzzle board
+     * representation of puzzle board, a bitmask per row with the cell in
+     * column c at bit c % 64 of word c / 64 (see Placements)
      */
-    private boolean[][] board;
+    private long[][] board;
 
     /**
      * row hints for puzzle
@@ -27,6 +29,27 @@ public class NonoBoard {
      */
     private ArrayList<Integer>[] colHints;
 
+    /**
+     * every placement of each row's hints, built once when the board is loaded
+     */
+    private long[][][] placements;
+
+    /**
+     * words changed by the logged marks, as row * WORDS + word, in the
+     * order they changed so they can be restored in reverse
+     */
+    private int[] trail = new int[64];
+
+    /**
+     * the value each word on the trail held before it changed
+     */
+    private long[] trailOld = new long[64];
+
+    /**
+     * number of words on the trail
+     */
+    private int trailSize = 0;
+
     /**
      * public value for number of rows
      */
@@ -37,6 +60,11 @@ public class NonoBoard {
      */
     public final int NUMBER_OF_COLS;
 
+    /**
+     * public value for number of words in a row's bitmask
+     */
+    public final int WORDS;
+
     /**
      * Constructor to build the initial board along with row and column hints
      *
@@ -51,7 +79,7 @@ public class NonoBoard {
             rowNum = file.nextInt();
             colNum = file.nextInt();
 
-            board = new boolean[rowNum][colNum];
+            board = new long[rowNum][Placements.words(colNum)];
 
             file.nextLine();
             file.nextLine();
@@ -67,6 +95,12 @@ public class NonoBoard {
 
         this.NUMBER_OF_ROWS = rowNum;
         this.NUMBER_OF_COLS = colNum;
+        this.WORDS = Placements.words(colNum);
+
+        // the placements of every row's hints
+        placements = new long[rowNum][][];
+        for (int r = 0; r < rowNum; r++)
+            placements[r] = Placements.of(Placements.blocks(rowHints[r]), colNum);
     }
 
     /**
@@ -77,9 +111,11 @@ public class NonoBoard {
     public NonoBoard(NonoBoard other) {
         this.NUMBER_OF_COLS = other.NUMBER_OF_COLS;
         this.NUMBER_OF_ROWS = other.NUMBER_OF_ROWS;
+        this.WORDS = other.WORDS;
 
         this.rowHints = other.rowHints;
         this.colHints = other.colHints;
+        this.placements = other.placements;
 
         this.board = copyBoard(other.board);
     }
@@ -90,11 +126,10 @@ public class NonoBoard {
      * @param board - the board to copy
      * @return - new board object
      */
-    private boolean[][] copyBoard(boolean[][] board) {
-        boolean[][] newBoard = new boolean[this.NUMBER_OF_ROWS][this.NUMBER_OF_COLS];
-        for (int r = 0; r < NUMBER_OF_ROWS; r++) {
-            if (NUMBER_OF_COLS >= 0) System.arraycopy(board[r], 0, newBoard[r], 0, NUMBER_OF_COLS);
-        }
+    private long[][] copyBoard(long[][] board) {
+        long[][] newBoard = new long[this.NUMBER_OF_ROWS][];
+        for (int r = 0; r < NUMBER_OF_ROWS; r++)
+            newBoard[r] = board[r].clone();
         return newBoard;
     }
 
@@ -137,8 +172,25 @@ public class NonoBoard {
     }
 
 
+    /**
+     * Get every placement of a row's hints
+     *
+     * @param row the row number
+     * @return the placements as bitmasks, in the order the search tries them
+     */
+    public long[][] getPlacements(int row) {
+        return placements[row];
+    }
+
+    /**
+     * Is a cell on the board marked
+     *
+     * @param row the row of the cell
+     * @param col the column of the cell
+     * @return true if marked; otherwise, false
+     */
     public boolean isMarked(int row, int col) {
-        return board[row][col];
+        return (board[row][col >>> 6] >>> (col & 63) & 1) != 0;
     }
 
     /**
@@ -154,13 +206,60 @@ public class NonoBoard {
         if (col + len > NUMBER_OF_COLS || row < 0 || col < 0 || len < 0)
             return false;
 
-        for (int i = col; i < col + len; i++)
-            board[row][i] = markdown;
+        for (int i = col; i < col + len; i++) {
+            if (markdown)
+                board[row][i >>> 6] |= 1L << (i & 63);
+            else
+                board[row][i >>> 6] &= ~(1L << (i & 63));
+        }
 
         return true;
     }
 
 
+    /**
+     * Mark a placement on a row, logging every word that changes on the
+     * undo trail
+     *
+     * @param row  the row to mark
+     * @param bits the cells to mark, as a bitmask of the row
+     */
+    public void markLogged(int row, long[] bits) {
+        for (int w = 0; w < WORDS; w++) {
+            long old = board[row][w];
+            if ((old | bits[w]) != old) {
+                if (trailSize == trail.length) {
+                    trail = Arrays.copyOf(trail, 2 * trail.length);
+                    trailOld = Arrays.copyOf(trailOld, 2 * trailOld.length);
+                }
+                trail[trailSize] = row * WORDS + w;
+                trailOld[trailSize++] = old;
+                board[row][w] = old | bits[w];
+            }
+        }
+    }
+
+    /**
+     * Get the current length of the undo trail, to restore back to later
+     *
+     * @return the number of words on the trail
+     */
+    public int trailMark() {
+        return trailSize;
+    }
+
+    /**
+     * Restore the words changed since the trail had the given length
+     *
+     * @param mark a length returned by trailMark
+     */
+    public void undo(int mark) {
+        while (trailSize > mark) {
+            int word = trail[--trailSize];
+            board[word / WORDS][word % WORDS] = trailOld[trailSize];
+        }
+    }
+
     /**
      * helper function to make the border lines of the board
      *
@@ -187,7 +286,7 @@ public class NonoBoard {
         for (int i = 0; i < board.length; i++) {
             s.append("|");
             for (int j = 0; j < NUMBER_OF_COLS; j++) {
-                s.append(board[i][j] ? '@' : ' ').append("|");
+                s.append(isMarked(i, j) ? '@' : ' ').append("|");
             }
             s.append("\n").append(border()).append("\n");
         }
@@ -1,3 +1,4 @@
+import java.io.IOException;
 import java.util.Optional;
 
 /**
@@ -7,28 +8,69 @@ import java.util.Optional;
  * @version 1.0
  */
 public class Nonogram {
+    /**
+     * Usage message
+     */
+    private static final String USAGE = "Usage: java Nonogram config-file [debug: true|false] " +
+            "[search: inplace|copy|parallel] [sample: trace 1 in N nodes] [depth: deepest traced]";
+
     /**
      * Main method to simulate the Nonogram solver, including the Backtracker and initial board configuration
      *
-     * @param args [0]: configuration file, [1]: enable debugger (optional)
+     * @param args [0]: configuration file, [1]: enable debugger (optional),
+     *             [2]: search, inplace (default), copy, or parallel (optional),
+     *             [3]: trace one in every this many nodes (optional),
+     *             [4]: deepest depth traced (optional)
      */
     public static void main(String[] args) {
         boolean debug = false;
+        String search = "inplace";
+        int sample = 1, depth = Integer.MAX_VALUE;
 
         // invalid number of arguments
-        if (args.length < 1 || args.length > 3) {
-            System.err.println("Usage: java Nonogram config-file [debug: true|false]");
+        if (args.length < 1 || args.length > 5) {
+            System.err.println(USAGE);
             System.exit(1);
         }
 
         // debug is enabled
-        if (args.length == 2 && args[1].equals("true"))
+        if (args.length >= 2 && args[1].equals("true"))
             debug = true;
 
+        if (args.length >= 3)
+            search = args[2];
+        try {
+            if (args.length >= 4)
+                sample = Integer.parseInt(args[3]);
+            if (args.length == 5)
+                depth = Integer.parseInt(args[4]);
+        } catch (NumberFormatException nfe) {
+            System.err.println(USAGE);
+            System.exit(1);
+        }
+        if (!search.equals("inplace") && !search.equals("copy") && !search.equals("parallel")) {
+            System.err.println(USAGE);
+            System.exit(1);
+        }
+
         // initialize the objects
         NonoBoard board = new NonoBoard(args[0]);
-        Backtracker bt = new Backtracker(debug);
-        Optional<Configuration> sol = bt.solve(new NonogramConfig(board));
+        Optional<Configuration> sol;
+        if (search.equals("parallel"))
+            sol = new ParallelBacktracker().solve(new InPlaceConfig(board));
+        else {
+            Backtracker bt = new Backtracker(false);
+            if (debug) {
+                try {
+                    bt = new Backtracker(new Tracer("debug", sample, depth));
+                } catch (IOException ioe) {
+                    System.err.println("[Error] Cannot open debug file: " + ioe.getMessage());
+                    System.exit(1);
+                }
+            }
+            sol = bt.solve(search.equals("copy") ?
+                    new NonogramConfig(board) : new InPlaceConfig(board));
+        }
 
         // print the solution
         System.out.println(sol.isPresent() ? sol.get() : "No Solution!");
@@ -78,6 +78,16 @@ public class NonogramConfig implements Configuration {
             successors.add(config);
     }
 
+    /**
+     * The row marked last, for tracing a search
+     *
+     * @return the row
+     */
+    @Override
+    public String traceLabel() {
+        return String.valueOf(status);
+    }
+
     /**
      * Validates by comparing the column hints to the respective columns on the board
      *
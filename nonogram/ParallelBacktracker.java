@@ -0,0 +1,177 @@
+import java.util.ArrayDeque;
+import java.util.Optional;
+import java.util.concurrent.ForkJoinPool;
+import java.util.concurrent.RecursiveAction;
+import java.util.concurrent.atomic.AtomicReference;
+
+/**
+ * This class represents the backtracking algorithm spread over the cores
+ * of the machine. The successors of a configuration are independent
+ * subtrees, so down to a cutoff depth each valid successor is forked
+ * into a task of its own, and below it each task backtracks sequentially.
+ * The first solution found stops every task.
+ * <p>
+ * A task only forks a copy of a successor (see Configuration.fork), and
+ * holds at most a bounded number of forked successors that have not
+ * finished, so the copies in memory stay bounded however many successors
+ * a configuration has.
+ *
+ * @author awallien (Alex Wall)
+ * @version 1.0
+ */
+public class ParallelBacktracker {
+
+    /**
+     * default depth below which the search is no longer forked
+     */
+    public static final int DEFAULT_CUTOFF = 4;
+
+    /**
+     * default number of unfinished forked successors per task
+     */
+    public static final int DEFAULT_FORKS = 16;
+
+    /**
+     * depth below which the search is no longer forked
+     */
+    private final int cutoff;
+
+    /**
+     * number of unfinished forked successors a task may hold
+     */
+    private final int forks;
+
+    /**
+     * number of threads searching
+     */
+    private final int threads;
+
+    /**
+     * the first solution found, shared by every task; once set, every
+     * task stops
+     */
+    private final AtomicReference<Configuration> solution = new AtomicReference<Configuration>();
+
+    /**
+     * Initialize a new parallel backtracker with the default cutoff and
+     * forks, on every core
+     */
+    public ParallelBacktracker() {
+        this(DEFAULT_CUTOFF, DEFAULT_FORKS, Runtime.getRuntime().availableProcessors());
+    }
+
+    /**
+     * Initialize a new parallel backtracker
+     *
+     * @param cutoff  - depth below which the search is no longer forked
+     * @param forks   - number of unfinished forked successors per task
+     * @param threads - number of threads searching
+     */
+    public ParallelBacktracker(int cutoff, int forks, int threads) {
+        this.cutoff = cutoff;
+        this.forks = Math.max(1, forks);
+        this.threads = Math.max(1, threads);
+    }
+
+    /**
+     * Try find a solution, if one exists, for a given configuration.
+     *
+     * @param config A valid configuration
+     * @return A solution config, or empty if no solution
+     */
+    public Optional<Configuration> solve(Configuration config) {
+        ForkJoinPool pool = new ForkJoinPool(threads);
+        solution.set(null);
+        try {
+            pool.invoke(new Search(config, 0));
+        } finally {
+            pool.shutdown();
+        }
+        return Optional.ofNullable(solution.get());
+    }
+
+    /**
+     * Helper function to backtrack sequentially, stopping once any task
+     * has found a solution
+     *
+     * @param config A valid configuration
+     * @return true if the search should stop; otherwise, false
+     */
+    private boolean backtrack(Configuration config) {
+        if (solution.get() != null)
+            return true;
+        if (config.isGoal()) {
+            solution.compareAndSet(null, config);
+            return true;
+        }
+
+        for (Configuration child : config.getSuccessors())
+            if (child.isValid() && backtrack(child))
+                return true;
+        return false;
+    }
+
+    /**
+     * The search of the subtree under one configuration
+     */
+    private class Search extends RecursiveAction {
+
+        /**
+         * the configuration at the top of the subtree, which this task
+         * alone searches
+         */
+        private final Configuration config;
+
+        /**
+         * its depth in the whole search
+         */
+        private final int depth;
+
+        /**
+         * Constructor
+         *
+         * @param config - the configuration to search under
+         * @param depth  - its depth
+         */
+        Search(Configuration config, int depth) {
+            this.config = config;
+            this.depth = depth;
+        }
+
+        /**
+         * Fork a task for each valid successor, or below the cutoff,
+         * backtrack through them here
+         */
+        @Override
+        protected void compute() {
+            if (depth >= cutoff) {
+                backtrack(config);
+                return;
+            }
+            if (solution.get() != null)
+                return;
+            if (config.isGoal()) {
+                solution.compareAndSet(null, config);
+                return;
+            }
+
+            ArrayDeque<Search> pending = new ArrayDeque<Search>();
+            for (Configuration child : config.getSuccessors()) {
+                if (solution.get() != null)
+                    break;
+                if (!child.isValid())
+                    continue;
+
+                // wait for the oldest fork before holding another copy
+                if (pending.size() == forks)
+                    pending.poll().join();
+                Search task = new Search(child.fork(), depth + 1);
+                task.fork();
+                pending.add(task);
+            }
+
+            for (Search task : pending)
+                task.join();
+        }
+    }
+}
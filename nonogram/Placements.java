@@ -0,0 +1,132 @@
+import java.util.ArrayList;
+
+/**
+ * Helper class to lay out the blocks of a line's hints: every placement
+ * of the blocks as a bitmask, cell i of the line at bit i % 64 of word
+ * i / 64, so a line of up to 64 cells is a single long
+ *
+ * @author awallien (Alex Wall)
+ * @version 1.0
+ */
+public class Placements {
+
+    /**
+     * Not instantiated; the class only holds the helpers
+     */
+    private Placements() {
+    }
+
+    /**
+     * The number of words a bitmask of a line takes
+     *
+     * @param width - the length of the line
+     * @return the number of longs
+     */
+    public static int words(int width) {
+        return (width + 63) / 64;
+    }
+
+    /**
+     * Set a run of bits in a bitmask
+     *
+     * @param bits - the bitmask
+     * @param from - the first bit
+     * @param len  - the number of bits
+     */
+    public static void set(long[] bits, int from, int len) {
+        for (int i = from; i < from + len; i++)
+            bits[i >>> 6] |= 1L << (i & 63);
+    }
+
+    /**
+     * Turn a hint list into the lengths of its blocks; the hint 0 is a
+     * line with no blocks
+     *
+     * @param hints - the hints for a line
+     * @return the block lengths
+     */
+    public static int[] blocks(ArrayList<Integer> hints) {
+        if (hints.size() == 1 && hints.get(0) == 0)
+            return new int[0];
+
+        int[] lengths = new int[hints.size()];
+        for (int i = 0; i < lengths.length; i++)
+            lengths[i] = hints.get(i);
+        return lengths;
+    }
+
+    /**
+     * Count the placements of blocks in a line, the ways of spreading its
+     * spare cells over the gaps around the blocks
+     *
+     * @param blocks - the block lengths
+     * @param width  - the length of the line
+     * @return the number of placements, at most Integer.MAX_VALUE
+     */
+    public static int count(int[] blocks, int width) {
+        int spare = width - blocks.length + 1;
+        for (int block : blocks)
+            spare -= block;
+        if (spare < 0)
+            return 0;
+
+        // choose where the blocks go among spare + blocks.length slots
+        long ways = 1;
+        for (int i = 1; i <= blocks.length; i++) {
+            ways = ways * (spare + i) / i;
+            if (ways > Integer.MAX_VALUE)
+                return Integer.MAX_VALUE;
+        }
+        return (int) ways;
+    }
+
+    /**
+     * Every placement of blocks in a line, in the order the copying search
+     * builds them: the last block moves right first, and each time an
+     * earlier block moves, the blocks after it start packed against it
+     *
+     * @param blocks - the block lengths
+     * @param width  - the length of the line
+     * @return the placements as bitmasks
+     */
+    public static long[][] of(int[] blocks, int width) {
+        long[][] table = new long[count(blocks, width)][];
+        int[] starts = new int[blocks.length];
+        int[] tail = new int[blocks.length];
+
+        // the cells each block and the blocks after it take up, gaps included
+        for (int i = blocks.length - 1; i >= 0; i--)
+            tail[i] = blocks[i] + (i + 1 < blocks.length ? tail[i + 1] + 1 : 0);
+        pack(blocks, starts, 0, 0);
+
+        for (int n = 0; n < table.length; n++) {
+            table[n] = new long[words(width)];
+            for (int i = 0; i < blocks.length; i++)
+                set(table[n], starts[i], blocks[i]);
+
+            // the last block that can still move right moves one cell
+            for (int i = blocks.length - 1; i >= 0; i--) {
+                if (starts[i] + 1 + tail[i] <= width) {
+                    pack(blocks, starts, i, starts[i] + 1);
+                    break;
+                }
+            }
+        }
+        return table;
+    }
+
+    /**
+     * Helper function to place blocks one after another, a gap apart
+     *
+     * @param blocks - the block lengths
+     * @param starts - the column each block starts at
+     * @param first  - the first block to place
+     * @param col    - the column it starts at
+     */
+    private static void pack(int[] blocks, int[] starts, int first, int col) {
+        for (int i = first; i < blocks.length; i++) {
+            starts[i] = col;
+            col += blocks[i] + 1;
+        }
+    }
+}
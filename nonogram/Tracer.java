@@ -0,0 +1,162 @@
+import java.io.BufferedWriter;
+import java.io.FileWriter;
+import java.io.IOException;
+import java.util.Arrays;
+import java.util.concurrent.ArrayBlockingQueue;
+import java.util.concurrent.BlockingQueue;
+import java.util.concurrent.CountDownLatch;
+
+/**
+ * Trace of a search, written to a file by a background thread through one
+ * buffered writer. The search hands each record to a bounded queue, so it
+ * only waits on the file when the writer falls a full queue behind.
+ * <p>
+ * A record is one line, the depth of the configuration, V, I or G for a
+ * valid, invalid or goal configuration, and the configuration's trace
+ * label (see Configuration.traceLabel). Records can be sampled, one in
+ * every so many, and cut off below a depth; goals are always recorded.
+ * The number of nodes at each depth is counted regardless, and written
+ * as a summary when the search reports.
+ *
+ * @author awallien (Alex Wall)
+ * @version 1.0
+ */
+public class Tracer {
+
+    /**
+     * number of records the queue holds before the search waits
+     */
+    private static final int CAPACITY = 1 << 14;
+
+    /**
+     * the records waiting to be written
+     */
+    private final BlockingQueue<Object> queue = new ArrayBlockingQueue<Object>(CAPACITY);
+
+    /**
+     * one in every how many nodes is recorded
+     */
+    private final int sample;
+
+    /**
+     * deepest depth recorded
+     */
+    private final int maxDepth;
+
+    /**
+     * nodes visited, so far, to sample by
+     */
+    private long visited = 0;
+
+    /**
+     * valid and invalid nodes counted at each depth
+     */
+    private long[] valid = new long[16], invalid = new long[16];
+
+    /**
+     * Constructor, recording every node
+     *
+     * @param filename - the file to append the trace to
+     * @throws IOException if the file cannot be opened
+     */
+    public Tracer(String filename) throws IOException {
+        this(filename, 1, Integer.MAX_VALUE);
+    }
+
+    /**
+     * Constructor
+     *
+     * @param filename - the file to append the trace to
+     * @param sample   - record one in every this many nodes
+     * @param maxDepth - deepest depth to record
+     * @throws IOException if the file cannot be opened
+     */
+    public Tracer(String filename, int sample, int maxDepth) throws IOException {
+        this.sample = Math.max(1, sample);
+        this.maxDepth = maxDepth;
+
+        final BufferedWriter out = new BufferedWriter(new FileWriter(filename, true));
+        Thread writer = new Thread(new Runnable() {
+            @Override
+            public void run() {
+                try {
+                    while (true) {
+                        Object record = queue.take();
+                        if (record instanceof CountDownLatch) {
+                            out.flush();
+                            ((CountDownLatch) record).countDown();
+                        } else
+                            out.write((String) record);
+                    }
+                } catch (IOException e) {
+                    e.printStackTrace();
+                    System.exit(1);
+                } catch (InterruptedException e) {
+                    // the program is exiting
+                }
+            }
+        }, "tracer");
+        writer.setDaemon(true);
+        writer.start();
+    }
+
+    /**
+     * Count a node and record it, if sampled and not too deep
+     *
+     * @param depth  - depth of the configuration, 0 at the root
+     * @param kind   - V, I or G for a valid, invalid or goal configuration
+     * @param config - the configuration
+     */
+    public void visit(int depth, char kind, Configuration config) {
+        if (depth >= valid.length) {
+            valid = Arrays.copyOf(valid, 2 * depth);
+            invalid = Arrays.copyOf(invalid, 2 * depth);
+        }
+        if (kind == 'I')
+            invalid[depth]++;
+        else if (kind == 'V')
+            valid[depth]++;
+
+        if (kind == 'G' || (visited++ % sample == 0 && depth <= maxDepth))
+            put(depth + " " + kind + " " + config.traceLabel() + "\n");
+    }
+
+    /**
+     * Write the summary of nodes per depth, reset the counts, and wait
+     * until everything recorded so far is on the file
+     */
+    public void report() {
+        StringBuilder s = new StringBuilder("# depth valid invalid\n");
+        for (int d = 0; d < valid.length; d++)
+            if (valid[d] + invalid[d] > 0)
+                s.append("# ").append(d).append(" ").append(valid[d])
+                        .append(" ").append(invalid[d]).append("\n");
+        put(s.toString());
+
+        Arrays.fill(valid, 0);
+        Arrays.fill(invalid, 0);
+        visited = 0;
+
+        CountDownLatch written = new CountDownLatch(1);
+        put(written);
+        try {
+            written.await();
+        } catch (InterruptedException e) {
+            Thread.currentThread().interrupt();
+        }
+    }
+
+    /**
+     * Helper function to hand a record to the writer, waiting while the
+     * queue is full
+     *
+     * @param record - a line of text, or a latch to count down once flushed
+     */
+    private void put(Object record) {
+        try {
+            queue.put(record);
+        } catch (InterruptedException e) {
+            Thread.currentThread().interrupt();
+        }
+    }
+}
@@ -7,8 +7,150 @@
     date: 1/30/2020
     revision: 1.0
 """
-from os.path import isfile
-from sys import argv
+from array import array
+from multiprocessing import Pool
+from os import replace
+from os.path import getmtime, isfile
+from socketserver import StreamRequestHandler, ThreadingTCPServer
+from struct import Struct
+from sys import argv, byteorder, stdout
+
+
+class NeighborIndex:
+    """index of the words one letter apart: a bucket per wildcard pattern, such as c*ld or co*d,
+    holding the words that match it, for every word length at once; saved to a file next to the
+    dictionary so that it is built once and loaded in one read after that"""
+
+    """file header: magic, number of words, bytes of words, number of buckets, number of members"""
+    header = Struct("<8sIIII")
+    magic = b"WLADIDX1"
+
+    """bucket of a word position that no other word shares"""
+    NONE = 0xFFFFFFFF
+
+    def __init__(self, words, word_buckets, offsets, members):
+        """Constructor
+        :param words: the words, in id order
+        :param word_buckets: the bucket of each position of each word, word after word
+        :param offsets: where each bucket starts in members, and where the last one ends
+        :param members: the ids of the words in each bucket, bucket after bucket
+        """
+        self.words = words
+        self.ids = {w: i for i, w in enumerate(words)}
+        self.word_buckets = word_buckets
+        self.offsets = offsets
+        self.members = members
+
+        """where each word's buckets start in word_buckets"""
+        self.starts = array('I', [0]) * (len(words) + 1)
+        for i, w in enumerate(words):
+            self.starts[i + 1] = self.starts[i] + len(w)
+
+    @classmethod
+    def build(cls, words):
+        """index a collection of words
+        :param words: the words, of any lengths
+        :return: the index
+        """
+        words = sorted(set(words))
+        buckets = dict()
+        for i, w in enumerate(words):
+            for j in range(len(w)):
+                buckets.setdefault(w[:j] + '*' + w[j + 1:], []).append(i)
+
+        # only the buckets shared by two words or more link anything
+        shared = dict()
+        offsets, members = array('I', [0]), array('I')
+        for pattern, ids in buckets.items():
+            if len(ids) > 1:
+                shared[pattern] = len(shared)
+                members.extend(ids)
+                offsets.append(len(members))
+
+        word_buckets = array('I')
+        for w in words:
+            word_buckets.extend(shared.get(w[:j] + '*' + w[j + 1:], cls.NONE) for j in range(len(w)))
+        return cls(words, word_buckets, offsets, members)
+
+    def save(self, path) -> None:
+        """write the index to a file, replacing it only once written whole
+        :param path: the file
+        """
+        blob = "\n".join(self.words).encode()
+        with open(path + ".tmp", "wb") as fp:
+            fp.write(self.header.pack(self.magic, len(self.words), len(blob), len(self.offsets) - 1,
+                                      len(self.members)))
+            fp.write(blob)
+            for a in (self.word_buckets, self.offsets, self.members):
+                fp.write(self.__little(a).tobytes())
+        replace(path + ".tmp", path)
+
+    @classmethod
+    def load(cls, path):
+        """read an index saved to a file, in one read
+        :param path: the file
+        :return: the index, or None if the file is not an index
+        """
+        with open(path, "rb") as fp:
+            data = fp.read()
+        if len(data) < cls.header.size:
+            return None
+        magic, n_words, n_blob, n_buckets, n_members = cls.header.unpack_from(data)
+        if magic != cls.magic:
+            return None
+
+        at = cls.header.size
+        words = data[at:at + n_blob].decode().split("\n") if n_words else []
+        at += n_blob
+        n_chars = sum(len(w) for w in words)
+        arrays = list()
+        for n in (n_chars, n_buckets + 1, n_members):
+            a = array('I')
+            a.frombytes(data[at:at + 4 * n])
+            arrays.append(cls.__little(a))
+            at += 4 * n
+        return cls(words, *arrays)
+
+    @staticmethod
+    def __little(a):
+        """helper function to put an array in the file's little-endian byte order, or back
+        :param a: an array of unsigned ints
+        :return: the array in the other order on a big-endian machine; otherwise, the array
+        """
+        if byteorder == "big":
+            a = array('I', a)
+            a.byteswap()
+        return a
+
+    def neighbors(self, i):
+        """get the words one letter apart from a word
+        :param i: the id of the word
+        :return: list of the ids of the words
+        """
+        res = list()
+        for j in range(self.starts[i], self.starts[i + 1]):
+            b = self.word_buckets[j]
+            if b != self.NONE:
+                res.extend(k for k in self.members[self.offsets[b]:self.offsets[b + 1]] if k != i)
+        return res
+
+    def successors(self, word):
+        """get the words one letter apart from any word; one missing from the index has no buckets,
+        so each letter is tried in its place instead
+        :param word: the word
+        :return: list of the words
+        """
+        i = self.ids.get(word)
+        if i is not None:
+            return [self.words[k] for k in self.neighbors(i)]
+
+        res = list()
+        for j in range(len(word)):
+            for a in Dictionary.valid_chars:
+                temp = word[:j] + a + word[j + 1:]
+                if temp in self.ids and temp != word:
+                    res.append(temp)
+        return res
 
 
 class Dictionary:
@@ -17,51 +159,37 @@ class Dictionary:
                   [chr(i) for i in range(ord('a'), ord('z') + 1)] + \
                   ['\'']
 
+    """the neighbor index of the dictionary file, loaded once"""
+    index = None
+
     @classmethod
-    def get_dict(cls, word_len) -> set:
-        """make a dictionary from given file
-        :param word_len: given length for a word
-        :return: a set of dictionary
+    def get_index(cls, dict_file=None) -> NeighborIndex:
+        """load the neighbor index of the dictionary file given, building it and saving it next to
+        the file if it is missing or older than the file
+        :param dict_file: the dictionary file, the one on the command line if None
+        :return: the neighbor index
         """
-        with open(argv[1]) as fp:
-            d = set()
-            for line in fp:
-                line = line.strip()
-                if len(line) == word_len:
-                    d.add(line)
-            return d
+        if cls.index is None:
+            dict_file = dict_file or argv[1]
+            path = dict_file + ".idx"
+            if isfile(path) and getmtime(path) >= getmtime(dict_file):
+                cls.index = NeighborIndex.load(path)
+            if cls.index is None:
+                with open(dict_file) as fp:
+                    cls.index = NeighborIndex.build(line.strip() for line in fp if line.strip())
+                try:
+                    cls.index.save(path)
+                except OSError:
+                    pass
+        return cls.index
 
 
 class Node:
-    def __init__(self, word, depth, goal, predecessor):
+    def __init__(self, word, depth, predecessor):
         """Constructor"""
         self.word = word
         self.depth = depth
-        self.goal = goal
         self.predecessor = predecessor
-        self.h = self.__h()
-
-    def __h(self):
-        """helper function to calculate the number of similar characters between
-        the temp and the goal word
-        :return: a number
-        """
-        return sum([1 for i in range(len(self.word)) if self.word[i] == self.goal[i]])
-
-    def get_successors(self, dictionary):
-        """get the successors for a word where each successor is changed by one letter
-        :param dictionary: collection of words with same length as self.word
-        :return: list of successors
-        """
-        res = list()
-        for i in range(len(self.word)):
-            left = self.word[:i]
-            right = self.word[i + 1:]
-            for a in Dictionary.valid_chars:
-                temp = left + a + right
-                if temp in dictionary and temp != self.word:
-                    res.append(Node(temp, self.depth + 1, self.goal, self))
-        return sorted(res, key=lambda x: [x.h, x.word], reverse=True)
 
     def __hash__(self):
         """for the purpose of adding this Node to a set"""
@@ -87,45 +215,245 @@ class Search:
         """the overall chain from start word to goal word"""
         self.chain: [Node, None] = None
 
-        """the limit on how far the search would go in depth"""
-        self.limit = len(start)**2
-
-        """collection of visited words at a depth where dict[word] = depth"""
-        self.visited = dict()
-
-        """collection of words with the same length as the starting or goal word"""
-        self.dictionary = Dictionary.get_dict(len(self.start))
+        """words one letter apart, indexed once for every search"""
+        self.index = Dictionary.get_index()
 
         self.__search()
 
     def __search(self):
-        """initialize the search"""
-        start_node = Node(self.start, 0, self.goal, None)
-        self.visited[start_node] = 0
-        self.__DLS(start_node)
-
-    def __DLS(self, word: Node):
-        """DFS but with a limit search when a better goal is found aka DLS"""
-        if word.word == self.goal and (not self.chain or word.depth < self.chain.depth):
-            self.chain = word
-            self.limit = word.depth
-        elif word.depth <= self.limit:
-            for successor in word.get_successors(self.dictionary):
-                if successor not in self.visited or self.visited[successor] > successor.depth:
-                    self.visited[successor] = successor.depth
-                    self.__DLS(successor)
+        """initialize the search and build the chain from the path found"""
+        path = self.__BFS()
+        if path is not None:
+            for depth, word in enumerate(path):
+                self.chain = Node(word, depth, self.chain)
+
+    def __BFS(self):
+        """bidirectional breadth-first search, from the start and the goal word, a level at a time
+        on whichever side has fewer words at its frontier, visiting each word at most once; the first
+        word reached from both sides joins a shortest chain
+        :return: the chain as a list of words, or None if no chain exists
+        """
+        if self.start == self.goal:
+            return [self.start]
+        ids = self.index.ids
+        if self.goal not in ids:
+            return None
+
+        # a start word missing from the dictionary starts from its successors instead
+        first = [ids[self.start]] if self.start in ids else [ids[w] for w in self.index.successors(self.start)]
+
+        """predecessor of each word reached from the start, and successor of each word reached from the goal"""
+        forward = {i: None for i in first}
+        backward = {ids[self.goal]: None}
+        frontiers = [list(forward), list(backward)]
+
+        meet = ids[self.goal] if ids[self.goal] in forward else None
+        while meet is None and frontiers[0] and frontiers[1]:
+            side = 0 if len(frontiers[0]) <= len(frontiers[1]) else 1
+            seen, other = (forward, backward) if side == 0 else (backward, forward)
+            level = list()
+            for i in frontiers[side]:
+                for j in self.index.neighbors(i):
+                    if j not in seen:
+                        seen[j] = i
+                        if j in other:
+                            meet = j
+                            break
+                        level.append(j)
+                if meet is not None:
+                    break
+            frontiers[side] = level
+
+        if meet is None:
+            return None
+        path = list()
+        i = meet
+        while i is not None:
+            path.append(self.index.words[i])
+            i = forward[i]
+        path.reverse()
+        if self.start not in ids:
+            path.insert(0, self.start)
+        i = backward[meet]
+        while i is not None:
+            path.append(self.index.words[i])
+            i = backward[i]
+        return path
+
+    def get_words(self):
+        """get the chain as a list of words
+        :return: the words from start to goal, or None if no chain was found
+        """
+        if self.chain is None:
+            return None
+        res = list()
+        c: Node = self.chain
+        while c is not None:
+            res.append(c.word)
+            c = c.predecessor
+        res.reverse()
+        return res
 
     def print_result(self) -> None:
         """print chain of words to output"""
-        c: Node = self.chain
-        if c is None:
-            print("No chain found!")
-        else:
-            res = ""
-            while c.predecessor is not None:
-                res = " => " + c.word + res
-                c = c.predecessor
-            print(c.word + res)
+        print(format_chain(self.get_words()))
+
+
+def format_chain(words) -> str:
+    """format a chain of words as it is printed
+    :param words: the words from start to goal, or None for no chain
+    :return: the chain, one word leading to the next
+    """
+    return "No chain found!" if words is None else " => ".join(words)
+
+
+def search_words(pair):
+    """search a chain between two words, in a batch worker
+    :param pair: the start and goal words
+    :return: the chain as a list of words, or None if no chain exists
+    """
+    return Search(*pair).get_words()
+
+
+class Batch:
+    """answers searches in batches: the words are split into the components of words that can reach
+    each other, computed once from the neighbor index, so pairs in different components are answered
+    without a search; the rest are searched by a pool of worker processes that share the index loaded
+    before they started, and every chain found is cached, reversed too"""
+
+    def __init__(self, workers):
+        """Constructor
+        :param workers: number of worker processes, 1 to search in this process
+        """
+        self.index = Dictionary.get_index()
+
+        """the component of each word, by id"""
+        self.components = self.__components()
+
+        """chain found for each pair searched, None if there is none"""
+        self.cache = dict()
+
+        self.pool = Pool(workers, Dictionary.get_index, (argv[1],)) if workers > 1 else None
+
+    def __components(self):
+        """helper function to join the words of each shared bucket, which are one letter apart and of
+        the same length, into components, by union-find
+        :return: array of the root of each word's component
+        """
+        parent = array('I', range(len(self.index.words)))
+
+        def find(i):
+            while parent[i] != i:
+                parent[i] = parent[parent[i]]
+                i = parent[i]
+            return i
+
+        offsets, members = self.index.offsets, self.index.members
+        for b in range(len(offsets) - 1):
+            root = find(members[offsets[b]])
+            for k in range(offsets[b] + 1, offsets[b + 1]):
+                other = find(members[k])
+                if other != root:
+                    parent[other] = root
+        for i in range(len(parent)):
+            parent[i] = find(i)
+        return parent
+
+    def reachable(self, start, goal) -> bool:
+        """can the goal word be reached from the start word at all
+        :param start: the start word
+        :param goal: the goal word
+        :return: False if no chain can exist; otherwise, True
+        """
+        ids = self.index.ids
+        if start == goal:
+            return True
+        if goal not in ids or len(start) != len(goal):
+            return False
+        if start in ids:
+            return self.components[ids[start]] == self.components[ids[goal]]
+
+        # a start word missing from the dictionary reaches the components of its successors
+        return any(self.components[ids[w]] == self.components[ids[goal]] for w in self.index.successors(start))
+
+    def answer(self, pairs):
+        """answer a batch of searches
+        :param pairs: list of (start, goal) word pairs, None for a query that is not a pair
+        :return: list of the chains, as lists of words or None for no chain, in the same order
+        """
+        todo = dict()
+        for pair in pairs:
+            if pair is None or pair in self.cache or pair in todo:
+                continue
+            if self.reachable(*pair):
+                todo[pair] = None
+            else:
+                self.cache[pair] = None
+        todo = list(todo)
+
+        chains = self.pool.map(search_words, todo) if self.pool else [search_words(pair) for pair in todo]
+        for pair, chain in zip(todo, chains):
+            self.cache[pair] = chain
+
+            # chains run both ways between words of the dictionary
+            if pair[0] in self.index.ids:
+                self.cache[pair[::-1]] = chain[::-1] if chain else chain
+
+        return [None if pair is None else self.cache[pair] for pair in pairs]
+
+    def close(self) -> None:
+        """stop the worker processes"""
+        if self.pool:
+            self.pool.close()
+            self.pool.join()
+
+
+def read_pairs(lines):
+    """read queries, a start and a goal word per line
+    :param lines: the lines of the queries
+    :return: list of (start, goal) pairs, None for a line that is not a pair
+    """
+    res = list()
+    for line in lines:
+        words = line.split()
+        if words:
+            res.append(tuple(words) if len(words) == 2 else None)
+    return res
+
+
+def batch(queries, workers) -> None:
+    """answer the queries in a file, printing one chain per query in order
+    :param queries: the file of queries
+    :param workers: number of worker processes
+    """
+    b = Batch(workers)
+    with open(queries) as fp:
+        pairs = read_pairs(fp)
+    for chain in b.answer(pairs):
+        stdout.write(format_chain(chain) + "\n")
+    b.close()
+
+
+def serve(port, workers) -> None:
+    """answer queries sent to a local socket: a client sends its queries and shuts down its side for
+    writing, and is sent one chain per query in order
+    :param port: the port on localhost to listen on
+    :param workers: number of worker processes
+    """
+    b = Batch(workers)
+
+    class Handler(StreamRequestHandler):
+        def handle(self):
+            pairs = read_pairs(line.decode() for line in self.rfile)
+            for chain in b.answer(pairs):
+                self.wfile.write((format_chain(chain) + "\n").encode())
+
+    with ThreadingTCPServer(("127.0.0.1", port), Handler) as server:
+        print("Answering queries on port", port)
+        try:
+            server.serve_forever()
+        finally:
+            b.close()
 
 
 def main() -> None:
@@ -145,9 +473,15 @@ def main() -> None:
 
 
 if __name__ == '__main__':
-    if len(argv) != 2:
-        print("Usage: python3 word_change.py [dict-file]")
+    if len(argv) < 2 or len(argv) > 4 or (len(argv) == 4 and not argv[3].isdigit()):
+        print("Usage: python3 word_change.py [dict-file] [queries-file | port] [workers]")
     elif not isfile(argv[1]):
         print("Dictionary does not exist: ", argv[1])
-    else:
+    elif len(argv) == 2:
         main()
+    elif isfile(argv[2]):
+        batch(argv[2], int(argv[3]) if len(argv) == 4 else 1)
+    elif argv[2].isdigit():
+        serve(int(argv[2]), int(argv[3]) if len(argv) == 4 else 1)
+    else:
+        print("Queries file does not exist: ", argv[2])